@@ -0,0 +1,58 @@
+#include "arena.hpp"
+
+#include <algorithm>
+#include <new>
+
+namespace SystemInfo {
+
+Arena::Arena(size_t initial_bytes) {
+    blocks_.push_back({std::make_unique_for_overwrite<std::byte[]>(initial_bytes), initial_bytes});
+}
+
+void Arena::reset() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (blocks_.size() > 1) {
+        size_t total = 0;
+        for (const Block& b : blocks_) total += b.size;
+        blocks_.clear();
+        blocks_.push_back({std::make_unique_for_overwrite<std::byte[]>(total), total});
+    }
+    offset_ = 0;
+    used_ = 0;
+}
+
+size_t Arena::used() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return used_;
+}
+
+size_t Arena::capacity() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t total = 0;
+    for (const Block& b : blocks_) total += b.size;
+    return total;
+}
+
+size_t Arena::blocks() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return blocks_.size();
+}
+
+void* Arena::do_allocate(size_t bytes, size_t alignment) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Block* block = &blocks_.back();
+    size_t start = (offset_ + alignment - 1) & ~(alignment - 1);
+    if (start + bytes > block->size) {
+        // new[] aligns to max_align_t, enough for anything an Info holds
+        if (alignment > alignof(std::max_align_t)) throw std::bad_alloc();
+        size_t size = std::max(block->size * 2, bytes);
+        blocks_.push_back({std::make_unique_for_overwrite<std::byte[]>(size), size});
+        block = &blocks_.back();
+        offset_ = start = 0;
+    }
+    used_ += start + bytes - offset_;
+    offset_ = start + bytes;
+    return block->data.get() + start;
+}
+
+} // namespace SystemInfo
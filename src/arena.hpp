@@ -0,0 +1,50 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <vector>
+
+namespace SystemInfo {
+
+// Bump allocator for the strings and lists of an ArenaInfo. Allocation
+// moves a pointer through one block and deallocation does nothing; reset()
+// takes the whole block back for the next fetch. A fetch that outgrows the
+// block spills into new ones, and the next reset() merges them into one
+// block that holds it all, so a sampling loop settles into a single
+// allocation made once.
+class Arena : public std::pmr::memory_resource {
+public:
+    explicit Arena(size_t initial_bytes = 16 * 1024);
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    // Frees nothing back to the heap. Everything allocated since the last
+    // reset must be gone or no longer used.
+    void reset();
+
+    size_t used() const;      // Bytes handed out since the last reset
+    size_t capacity() const;  // Bytes held from the heap
+    size_t blocks() const;
+
+private:
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void*, size_t, size_t) override {}
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+
+    struct Block {
+        std::unique_ptr<std::byte[]> data;
+        size_t size;
+    };
+
+    // Collectors fill their sections of one Info concurrently
+    mutable std::mutex mutex_;
+    std::vector<Block> blocks_;
+    size_t offset_ = 0;  // Into blocks_.back()
+    size_t used_ = 0;
+};
+
+} // namespace SystemInfo
@@ -0,0 +1,165 @@
+#include "cache.hpp"
+#include "wire.hpp"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace SystemInfo {
+
+// -------------------- file format --------------------
+//
+// "NACC", a format version, the key, then the static fields below in
+// wire.hpp encoding.
+
+namespace {
+
+constexpr uint32_t kMagic = 0x4343414e;  // "NACC"
+constexpr uint32_t kVersion = 2;
+
+template <class IO, class T> requires wire::Of<T, Info>
+void visitStatic(IO& io, T& info) {
+    io(info.os_name); io(info.os_version); io(info.os_codename);
+    io(info.kernel); io(info.kernel_version);
+
+    io(info.model); io(info.manufacturer); io(info.bios_version); io(info.board_name);
+
+    // The cpuinfo clock is only a fallback; cpufreq replaces it where present
+    auto& cpu = info.cpu;
+    io(cpu.model); io(cpu.vendor); io(cpu.core_count); io(cpu.thread_count);
+    io(cpu.max_freq_ghz); io(cpu.current_freq_ghz);
+    auto each = [&](auto& x) { io(x); };
+    io.list(cpu.per_cpu.package, each); io.list(cpu.per_cpu.core, each); io.list(cpu.per_cpu.node, each);
+
+    io.list(info.gpus, [&](auto& g) { wire::visit(io, g); });
+}
+
+// The boot ID changes on every boot; the os-release mtime catches an
+// upgrade installed since, which the running kernel would not reveal.
+std::string cacheKey() {
+    std::string key;
+    int fd = open("/proc/sys/kernel/random/boot_id", O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return key;
+    char buf[64];
+    ssize_t n = read(fd, buf, sizeof(buf));
+    close(fd);
+    if (n <= 0) return key;
+    key.assign(buf, n);
+    if (key.back() == '\n') key.pop_back();
+
+    struct stat st;
+    if (stat("/etc/os-release", &st) == 0)
+        key += ':' + std::to_string(st.st_mtim.tv_sec) + '.' + std::to_string(st.st_mtim.tv_nsec);
+    return key;
+}
+
+} // namespace
+
+// -------------------- STATIC CACHE --------------------
+
+std::string staticCachePath() {
+    if (const char* dir = getenv("XDG_RUNTIME_DIR"); dir && *dir)
+        return std::string(dir) + "/nacfetch-static.cache";
+    return "/tmp/nacfetch-" + std::to_string(getuid()) + "-static.cache";
+}
+
+template <class Alloc>
+bool readStaticCache(const std::string& path, BasicInfo<Alloc>& out) {
+    std::string key = cacheKey();
+    if (key.empty()) return false;
+
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC | O_NOFOLLOW);
+    if (fd < 0) return false;
+
+    // Never trust a file someone else could have planted in /tmp
+    struct stat st;
+    if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_uid != getuid() || st.st_size == 0) {
+        close(fd);
+        return false;
+    }
+    void* map = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) return false;
+
+    wire::Reader r(std::string_view(static_cast<const char*>(map), st.st_size));
+    std::string stored;
+    BasicInfo<Alloc> info;
+    bool ok = r.get() == kMagic && r.get() == kVersion;
+    if (ok) {
+        r(stored);
+        ok = r.ok() && stored == key;
+    }
+    if (ok) {
+        visitStatic(r, info);
+        ok = r.ok();
+    }
+    munmap(map, st.st_size);
+    if (!ok) return false;
+
+    out.os_name = std::move(info.os_name);
+    out.os_version = std::move(info.os_version);
+    out.os_codename = std::move(info.os_codename);
+    out.kernel = std::move(info.kernel);
+    out.kernel_version = std::move(info.kernel_version);
+    out.model = std::move(info.model);
+    out.manufacturer = std::move(info.manufacturer);
+    out.bios_version = std::move(info.bios_version);
+    out.board_name = std::move(info.board_name);
+    out.cpu.model = std::move(info.cpu.model);
+    out.cpu.vendor = std::move(info.cpu.vendor);
+    out.cpu.core_count = info.cpu.core_count;
+    out.cpu.thread_count = info.cpu.thread_count;
+    out.cpu.max_freq_ghz = info.cpu.max_freq_ghz;
+    out.cpu.current_freq_ghz = info.cpu.current_freq_ghz;
+    // Topology only: the sampled arrays start out unknown
+    out.cpu.per_cpu = std::move(info.cpu.per_cpu);
+    out.cpu.per_cpu.resize(out.cpu.per_cpu.package.size());
+    out.gpus = std::move(info.gpus);
+    return true;
+}
+
+template <class Alloc>
+bool writeStaticCache(const std::string& path, const BasicInfo<Alloc>& info) {
+    std::string key = cacheKey();
+    if (key.empty()) return false;
+
+    wire::Writer w;
+    w(kMagic);
+    w(kVersion);
+    w(key);
+    visitStatic(w, info);
+
+    // Readers either see the old file or the complete new one
+    std::string tmp = path + '.' + std::to_string(getpid());
+    // Only ever a file this call created: anything already at the name, a
+    // leftover or one planted in /tmp, is removed first or not written to
+    const int flags = O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC | O_NOFOLLOW;
+    int fd = open(tmp.c_str(), flags, 0600);
+    if (fd < 0 && errno == EEXIST && unlink(tmp.c_str()) == 0)
+        fd = open(tmp.c_str(), flags, 0600);
+    if (fd < 0) return false;
+    const char* p = w.out.data();
+    size_t left = w.out.size();
+    while (left > 0) {
+        ssize_t n = write(fd, p, left);
+        if (n <= 0) break;
+        p += n;
+        left -= n;
+    }
+    if (close(fd) != 0 || left > 0 || rename(tmp.c_str(), path.c_str()) != 0) {
+        unlink(tmp.c_str());
+        return false;
+    }
+    return true;
+}
+
+template bool readStaticCache(const std::string&, Info&);
+template bool readStaticCache(const std::string&, ArenaInfo&);
+template bool writeStaticCache(const std::string&, const Info&);
+template bool writeStaticCache(const std::string&, const ArenaInfo&);
+
+} // namespace SystemInfo
@@ -0,0 +1,24 @@
+#pragma once
+#include "sysinfo.hpp"
+#include <string>
+
+namespace SystemInfo {
+
+// Facts that cannot change before the next reboot (os-release, kernel,
+// DMI, CPU identity, GPUs) cached on disk, so a warm run only has to read
+// the volatile counters. Entries are keyed by the kernel's boot ID and the
+// os-release mtime; anything else invalidates them.
+
+// $XDG_RUNTIME_DIR/nacfetch-static.cache, or /tmp/nacfetch-<uid>-static.cache
+std::string staticCachePath();
+
+// Copies the cached static fields into `out`. Returns false, leaving it
+// alone, on a missing, foreign, stale or corrupt file.
+template <class Alloc>
+bool readStaticCache(const std::string& path, BasicInfo<Alloc>& out);
+
+// Atomically replaces the cache with the static fields of `info`
+template <class Alloc>
+bool writeStaticCache(const std::string& path, const BasicInfo<Alloc>& info);
+
+} // namespace SystemInfo
@@ -0,0 +1,193 @@
+#include "daemon.hpp"
+#include "wire.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+
+namespace SystemInfo {
+
+// -------------------- wire format --------------------
+//
+// "NACD", a format version, then every field of Info in declaration
+// order, encoded as described in wire.hpp.
+
+namespace {
+
+constexpr uint32_t kMagic = 0x4443414e;  // "NACD"
+constexpr uint32_t kVersion = 4;
+
+std::string encode(const Info& info) {
+    wire::Writer w;
+    w(kMagic);
+    w(kVersion);
+    wire::visit(w, info);
+    return std::move(w.out);
+}
+
+bool decode(std::string_view blob, Info& out) {
+    wire::Reader r(blob);
+    if (r.get() != kMagic || r.get() != kVersion) return false;
+    Info info;
+    wire::visit(r, info);
+    if (!r.ok()) return false;
+    out = std::move(info);
+    return true;
+}
+
+// -------------------- socket helpers --------------------
+
+bool socketAddress(const std::string& path, sockaddr_un& addr) {
+    if (path.size() >= sizeof(addr.sun_path)) return false;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+    return true;
+}
+
+// A stuck peer must never stall either side for long
+void setTimeouts(int fd, long usec) {
+    timeval tv{0, usec};
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+}
+
+volatile sig_atomic_t stop_requested = 0;
+
+void onStopSignal(int) { stop_requested = 1; }
+
+} // namespace
+
+// -------------------- DAEMON --------------------
+
+std::string daemonSocketPath() {
+    if (const char* dir = getenv("XDG_RUNTIME_DIR"); dir && *dir)
+        return std::string(dir) + "/nacfetch.sock";
+    return "/tmp/nacfetch-" + std::to_string(getuid()) + ".sock";
+}
+
+int runDaemon(const std::string& path, unsigned refresh_ms, const Flags& flags) {
+    Info probe;
+    if (requestInfo(path, probe)) {
+        fprintf(stderr, "nacfetch: a daemon is already serving %s\n", path.c_str());
+        return 1;
+    }
+
+    sockaddr_un addr;
+    if (!socketAddress(path, addr)) {
+        fprintf(stderr, "nacfetch: socket path too long: %s\n", path.c_str());
+        return 1;
+    }
+
+    int listener = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC | SOCK_NONBLOCK, 0);
+    if (listener < 0) {
+        perror("nacfetch: socket");
+        return 1;
+    }
+
+    // Only the owner may connect: the Info carries user and host details
+    unlink(path.c_str());
+    mode_t old_mask = umask(077);
+    int bound = bind(listener, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+    umask(old_mask);
+    if (bound != 0 || listen(listener, 64) != 0) {
+        perror("nacfetch: bind");
+        close(listener);
+        return 1;
+    }
+
+    struct sigaction sa{};
+    sa.sa_handler = onStopSignal;
+    sigaction(SIGINT, &sa, nullptr);
+    sigaction(SIGTERM, &sa, nullptr);
+
+    Fetcher fetcher;
+    fetcher.fetchInfo(flags);
+    std::string blob = encode(fetcher.getInfo());
+
+    // Identity and hardware stay as fetched; only the counters move. A
+    // refresh that overruns its interval keeps the previous values.
+    Flags refresh = flags;
+    refresh.deadline_us = flags.deadline_us ? flags.deadline_us : refresh_ms * 1000ull;
+
+    using Clock = std::chrono::steady_clock;
+    const auto interval = std::chrono::milliseconds(refresh_ms);
+    auto next_refresh = Clock::now() + interval;
+
+    while (!stop_requested) {
+        auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(next_refresh - Clock::now());
+        pollfd pfd{listener, POLLIN, 0};
+        int ready = poll(&pfd, 1, std::max<int>(0, static_cast<int>(wait.count())));
+        if (ready < 0 && errno != EINTR) {
+            perror("nacfetch: poll");
+            break;
+        }
+
+        if (ready > 0) {
+            int client;
+            while ((client = accept4(listener, nullptr, nullptr, SOCK_CLOEXEC)) >= 0) {
+                setTimeouts(client, 100000);
+                size_t sent = 0;
+                while (sent < blob.size()) {
+                    ssize_t n = send(client, blob.data() + sent, blob.size() - sent, MSG_NOSIGNAL);
+                    if (n <= 0) break;
+                    sent += n;
+                }
+                close(client);
+            }
+        }
+
+        if (Clock::now() >= next_refresh) {
+            fetcher.refresh(refresh);
+            blob = encode(fetcher.getInfo());
+            next_refresh = Clock::now() + interval;
+        }
+    }
+
+    close(listener);
+    unlink(path.c_str());
+    return 0;
+}
+
+bool requestInfo(const std::string& path, Info& out) {
+    sockaddr_un addr;
+    if (!socketAddress(path, addr)) return false;
+
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) return false;
+    setTimeouts(fd, 50000);
+
+    if (connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+        close(fd);
+        return false;
+    }
+
+    // Without XDG_RUNTIME_DIR the socket lives in /tmp, where any user
+    // could have bound it first: only trust a daemon running as us
+    ucred peer{};
+    socklen_t len = sizeof(peer);
+    if (getsockopt(fd, SOL_SOCKET, SO_PEERCRED, &peer, &len) != 0 || peer.uid != getuid()) {
+        close(fd);
+        return false;
+    }
+
+    std::string blob;
+    char buf[16384];
+    ssize_t n;
+    while ((n = read(fd, buf, sizeof(buf))) > 0)
+        blob.append(buf, n);
+    close(fd);
+
+    return n == 0 && decode(blob, out);
+}
+
+} // namespace SystemInfo
@@ -0,0 +1,23 @@
+#pragma once
+#include "sysinfo.hpp"
+#include <string>
+
+namespace SystemInfo {
+
+// Resident mode: one process keeps a Fetcher alive and serves its Info
+// over a Unix domain socket, so shells do not re-walk sysfs on startup.
+
+// $XDG_RUNTIME_DIR/nacfetch.sock, or /tmp/nacfetch-<uid>.sock without it
+std::string daemonSocketPath();
+
+// Fetches everything once, then serves it on `path` until SIGINT/SIGTERM,
+// re-reading the volatile fields (see Fetcher::refresh) every refresh_ms.
+// Returns the process exit status.
+int runDaemon(const std::string& path, unsigned refresh_ms, const Flags& flags);
+
+// Reads the daemon's current Info. Returns false, leaving `out` alone, if
+// no daemon answers within a few milliseconds, it runs as another user or
+// it speaks another format.
+bool requestInfo(const std::string& path, Info& out);
+
+} // namespace SystemInfo
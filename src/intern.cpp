@@ -0,0 +1,67 @@
+#include "intern.hpp"
+
+#include <deque>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+
+namespace SystemInfo {
+
+namespace {
+
+// Values nearly every machine has, found without taking the lock
+constexpr std::string_view kCommon[] = {
+    // Disk::filesystem
+    "ext4", "btrfs", "xfs", "vfat", "exfat", "ntfs3", "fuseblk", "zfs", "f2fs", "ext3", "ext2",
+    "nfs", "nfs4", "cifs", "overlay",
+    // CPU::vendor, GPU::vendor
+    "Intel", "AMD", "NVIDIA", "Apple", "Unknown",
+    // NetworkInterface::operstate
+    "up", "down", "unknown", "dormant", "lowerlayerdown", "notpresent", "testing",
+    // Battery::status
+    "Charging", "Discharging", "Full", "Not charging",
+};
+
+// Everything else, added on first sight. Deques never move what they
+// already hold, so entries stay put as the table grows.
+struct Table {
+    std::mutex mutex;
+    std::deque<std::string> strings;
+    std::deque<std::string_view> entries;
+    std::unordered_map<std::string_view, const std::string_view*> index;
+};
+
+Table& table() {
+    // Never destroyed: Atoms in other statics may outlive it otherwise
+    static Table* t = new Table;
+    return *t;
+}
+
+} // namespace
+
+Atom::Atom(std::string_view text) {
+    if (text.empty()) return;
+    for (const std::string_view& common : kCommon) {
+        if (common == text) {
+            entry_ = &common;
+            return;
+        }
+    }
+
+    Table& t = table();
+    std::lock_guard<std::mutex> lock(t.mutex);
+    if (auto it = t.index.find(text); it != t.index.end()) {
+        entry_ = it->second;
+        return;
+    }
+    const std::string& copy = t.strings.emplace_back(text);
+    entry_ = &t.entries.emplace_back(copy);
+    t.index.emplace(*entry_, entry_);
+}
+
+std::ostream& operator<<(std::ostream& out, Atom atom) {
+    return out << atom.view();
+}
+
+} // namespace SystemInfo
@@ -0,0 +1,36 @@
+#pragma once
+#include <cstddef>
+#include <iosfwd>
+#include <string_view>
+
+namespace SystemInfo {
+
+// A string from a small, mostly closed set: filesystem types, vendors,
+// link and battery states. Each distinct value is stored once, in a
+// process-wide table that is never freed, so an Atom is one pointer that
+// copies for free and compares with another Atom as an integer.
+class Atom {
+public:
+    Atom() = default;
+    explicit Atom(std::string_view text);  // Finds `text` in the table, or adds it
+
+    Atom& operator=(std::string_view text) { return *this = Atom(text); }
+
+    std::string_view view() const { return *entry_; }
+    operator std::string_view() const { return *entry_; }
+    const char* c_str() const { return entry_->data(); }  // Table strings are NUL-terminated
+    size_t size() const { return entry_->size(); }
+    bool empty() const { return entry_->empty(); }
+    void clear() { entry_ = &kEmpty; }
+
+    friend bool operator==(Atom a, Atom b) { return a.entry_ == b.entry_; }
+    friend bool operator==(Atom a, std::string_view b) { return *a.entry_ == b; }
+
+private:
+    static constexpr std::string_view kEmpty{""};
+    const std::string_view* entry_ = &kEmpty;
+};
+
+std::ostream& operator<<(std::ostream& out, Atom atom);
+
+} // namespace SystemInfo
@@ -0,0 +1,265 @@
+#include "io_batch.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <unistd.h>
+
+#ifdef NACFETCH_IO_URING
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+
+namespace SystemInfo {
+
+namespace {
+
+// Fallback, and the whole story for small batches
+void readOne(ReadRequest& r) {
+    bool opened = false;
+    if (r.fd < 0) {
+        r.fd = openat(r.dirfd, r.path, O_RDONLY | O_CLOEXEC);
+        if (r.fd < 0) {
+            r.result = -errno;
+            return;
+        }
+        opened = true;
+    }
+    r.result = pread(r.fd, r.buf, r.size - 1, 0);
+    if (r.result < 0)
+        r.result = -errno;
+    else
+        r.buf[r.result] = '\0';
+    if (opened && !r.keep) {
+        close(r.fd);
+        r.fd = -1;
+    }
+}
+
+#ifdef NACFETCH_IO_URING
+
+// Minimal io_uring over the raw syscalls: submit a run of SQEs, wait for
+// all of their completions. One ring per thread, set up on first use.
+class Ring {
+public:
+    static constexpr unsigned kEntries = 64;
+
+    ~Ring() {
+        if (fd_ < 0) return;
+        munmap(sqes_, sqes_len_);
+        if (cq_ptr_ != sq_ptr_) munmap(cq_ptr_, cq_len_);
+        munmap(sq_ptr_, sq_len_);
+        close(fd_);
+    }
+
+    bool ready() {
+        if (disabled.load(std::memory_order_relaxed)) return false;
+        if (failed_) return false;
+        if (fd_ >= 0) return true;
+        failed_ = !setup();
+        // Kernels without io_uring, or with it blocked by a sysctl or a
+        // seccomp filter, will not change their mind: stop trying anywhere
+        if (failed_) disabled.store(true, std::memory_order_relaxed);
+        return !failed_;
+    }
+
+    io_uring_sqe* next() {
+        unsigned tail = *sq_tail_ + pending_;
+        io_uring_sqe* sqe = &sqes_[tail & *sq_mask_];
+        sq_array_[tail & *sq_mask_] = tail & *sq_mask_;
+        memset(sqe, 0, sizeof(*sqe));
+        ++pending_;
+        return sqe;
+    }
+
+    // Submits everything queued by next() and hands each completion to fn.
+    // On failure the ring is not used again, but only once every entry the
+    // kernel took has completed: until then it may still write to the
+    // caller's buffers.
+    template <class F>
+    bool submitAndWait(F&& fn) {
+        unsigned n = pending_;
+        pending_ = 0;
+        if (n == 0) return true;
+        __atomic_store_n(sq_tail_, *sq_tail_ + n, __ATOMIC_RELEASE);
+
+        unsigned submitted = 0, done = 0;
+        while (done < (failed_ ? submitted : n)) {
+            long rc = syscall(__NR_io_uring_enter, fd_, failed_ ? 0 : n - submitted,
+                              (failed_ ? submitted : n) - done, IORING_ENTER_GETEVENTS, nullptr, 0);
+            if (rc >= 0) {
+                submitted += rc;
+            } else if (errno != EINTR) {
+                // Completions still land in the CQ ring without entering,
+                // so keep polling it when even waiting fails
+                if (failed_) usleep(1000);
+                failed_ = true;
+            }
+
+            unsigned head = *cq_head_;
+            unsigned tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+            for (; head != tail; ++head, ++done) {
+                const io_uring_cqe& cqe = cqes_[head & *cq_mask_];
+                fn(cqe.user_data, cqe.res);
+            }
+            __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+        }
+        return !failed_;
+    }
+
+    static inline std::atomic<bool> disabled{false};
+
+private:
+    bool setup() {
+        io_uring_params p{};
+        fd_ = syscall(__NR_io_uring_setup, kEntries, &p);
+        if (fd_ < 0) return false;
+
+        sq_len_ = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+        cq_len_ = p.cq_off.cqes + p.cq_entries * sizeof(io_uring_cqe);
+        if (p.features & IORING_FEAT_SINGLE_MMAP)
+            sq_len_ = cq_len_ = std::max(sq_len_, cq_len_);
+        sqes_len_ = p.sq_entries * sizeof(io_uring_sqe);
+
+        sq_ptr_ = mmap(nullptr, sq_len_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_SQ_RING);
+        cq_ptr_ = (p.features & IORING_FEAT_SINGLE_MMAP)
+                      ? sq_ptr_
+                      : mmap(nullptr, cq_len_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_CQ_RING);
+        void* sqes = mmap(nullptr, sqes_len_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_SQES);
+        if (sq_ptr_ == MAP_FAILED || cq_ptr_ == MAP_FAILED || sqes == MAP_FAILED) {
+            if (sqes != MAP_FAILED) munmap(sqes, sqes_len_);
+            if (cq_ptr_ != MAP_FAILED && cq_ptr_ != sq_ptr_) munmap(cq_ptr_, cq_len_);
+            if (sq_ptr_ != MAP_FAILED) munmap(sq_ptr_, sq_len_);
+            close(fd_);
+            fd_ = -1;
+            return false;
+        }
+
+        auto* sq = static_cast<char*>(sq_ptr_);
+        sq_tail_ = reinterpret_cast<unsigned*>(sq + p.sq_off.tail);
+        sq_mask_ = reinterpret_cast<unsigned*>(sq + p.sq_off.ring_mask);
+        sq_array_ = reinterpret_cast<unsigned*>(sq + p.sq_off.array);
+        sqes_ = static_cast<io_uring_sqe*>(sqes);
+
+        auto* cq = static_cast<char*>(cq_ptr_);
+        cq_head_ = reinterpret_cast<unsigned*>(cq + p.cq_off.head);
+        cq_tail_ = reinterpret_cast<unsigned*>(cq + p.cq_off.tail);
+        cq_mask_ = reinterpret_cast<unsigned*>(cq + p.cq_off.ring_mask);
+        cqes_ = reinterpret_cast<io_uring_cqe*>(cq + p.cq_off.cqes);
+        return true;
+    }
+
+    int fd_ = -1;
+    bool failed_ = false;
+    unsigned pending_ = 0;
+
+    void* sq_ptr_ = nullptr;
+    void* cq_ptr_ = nullptr;
+    size_t sq_len_ = 0, cq_len_ = 0, sqes_len_ = 0;
+    unsigned *sq_tail_ = nullptr, *sq_mask_ = nullptr, *sq_array_ = nullptr;
+    unsigned *cq_head_ = nullptr, *cq_tail_ = nullptr, *cq_mask_ = nullptr;
+    io_uring_sqe* sqes_ = nullptr;
+    io_uring_cqe* cqes_ = nullptr;
+};
+
+thread_local Ring ring;
+
+// Below this many files the ring's three submissions cost more than the
+// plain syscalls they replace
+constexpr size_t kMinBatch = 4;
+
+// Opens, then reads, then closes one chunk, one submission per phase.
+// Returns false if the ring itself failed; the caller redoes the chunk.
+bool readChunk(std::span<ReadRequest> chunk) {
+    std::array<bool, Ring::kEntries> opened{};
+    for (size_t i = 0; i < chunk.size(); ++i) {
+        ReadRequest& r = chunk[i];
+        if (r.fd >= 0) continue;
+        io_uring_sqe* sqe = ring.next();
+        sqe->opcode = IORING_OP_OPENAT;
+        sqe->fd = r.dirfd;
+        sqe->addr = reinterpret_cast<uintptr_t>(r.path);
+        sqe->open_flags = O_RDONLY | O_CLOEXEC;
+        sqe->user_data = i;
+    }
+    bool ok = ring.submitAndWait([&](uint64_t i, int res) {
+        chunk[i].fd = res >= 0 ? res : -1;
+        chunk[i].result = res >= 0 ? -1 : res;
+        opened[i] = res >= 0;
+    });
+    if (!ok) {
+        // Opens that did complete before the ring failed still hold fds
+        for (size_t i = 0; i < chunk.size(); ++i) {
+            if (!opened[i]) continue;
+            close(chunk[i].fd);
+            chunk[i].fd = -1;
+        }
+        return false;
+    }
+
+    for (size_t i = 0; i < chunk.size(); ++i) {
+        ReadRequest& r = chunk[i];
+        if (r.fd < 0) continue;
+        io_uring_sqe* sqe = ring.next();
+        sqe->opcode = IORING_OP_READ;
+        sqe->fd = r.fd;
+        sqe->addr = reinterpret_cast<uintptr_t>(r.buf);
+        sqe->len = r.size - 1;
+        sqe->off = 0;
+        sqe->user_data = i;
+    }
+    ok = ring.submitAndWait([&](uint64_t i, int res) {
+        ReadRequest& r = chunk[i];
+        r.result = res;
+        if (res >= 0) r.buf[res] = '\0';
+    });
+
+    for (size_t i = 0; i < chunk.size(); ++i) {
+        ReadRequest& r = chunk[i];
+        if (!opened[i] || r.keep) continue;
+        if (!ok) {
+            close(r.fd);  // Not through a ring that just failed
+        } else {
+            io_uring_sqe* sqe = ring.next();
+            sqe->opcode = IORING_OP_CLOSE;
+            sqe->fd = r.fd;
+            sqe->user_data = i;
+        }
+        r.fd = -1;
+    }
+    ring.submitAndWait([](uint64_t, int) {});
+    return ok;
+}
+
+#endif
+
+} // namespace
+
+void readBatch(std::span<ReadRequest> requests) {
+#ifdef NACFETCH_IO_URING
+    if (requests.size() >= kMinBatch && ring.ready()) {
+        for (size_t start = 0; start < requests.size(); start += Ring::kEntries) {
+            auto chunk = requests.subspan(start, std::min<size_t>(Ring::kEntries, requests.size() - start));
+            if (ring.ready() && readChunk(chunk)) {
+                // Opcodes this kernel lacks (pre-5.6) fail with EINVAL
+                for (ReadRequest& r : chunk) {
+                    if (r.result == -EINVAL) readOne(r);
+                }
+                continue;
+            }
+            Ring::disabled.store(true, std::memory_order_relaxed);
+            for (ReadRequest& r : chunk) {
+                if (r.result < 0) readOne(r);
+            }
+        }
+        return;
+    }
+#endif
+    for (ReadRequest& r : requests)
+        readOne(r);
+}
+
+} // namespace SystemInfo
@@ -0,0 +1,27 @@
+#pragma once
+#include <cstddef>
+#include <span>
+#include <fcntl.h>
+#include <sys/types.h>
+
+namespace SystemInfo {
+
+// One small file to read as part of a batch
+struct ReadRequest {
+    int dirfd = AT_FDCWD;
+    const char* path = nullptr;  // Opened by the batch when fd < 0
+    int fd = -1;                 // Already open: read at offset 0
+    bool keep = false;           // Leave a file the batch opened open, in fd
+    char* buf = nullptr;
+    size_t size = 0;
+    ssize_t result = -1;         // Bytes read, NUL-terminated in buf, or -errno
+};
+
+// Reads many small procfs/sysfs files at once. Built with
+// NACFETCH_IO_URING and on a kernel that allows it, every open of the
+// batch goes to the kernel in one io_uring_enter, then every read, then
+// every close. Otherwise, or for a batch too small to pay for that, each
+// file costs its usual openat/read/close.
+void readBatch(std::span<ReadRequest> requests);
+
+} // namespace SystemInfo
@@ -0,0 +1,297 @@
+#include "json.hpp"
+#include "wire.hpp"
+
+#include <charconv>
+#include <cmath>
+#include <cstring>
+
+namespace SystemInfo {
+
+namespace {
+
+// -------------------- ESCAPING --------------------
+
+// Sixteen bytes at a time through the GCC/Clang vector extensions: a
+// comparison yields all-ones in every lane where it holds
+typedef unsigned char Bytes __attribute__((vector_size(16)));
+
+// Length of the prefix of `s` that needs no escaping: no quote, backslash
+// or control character. Bytes from 0x80 up are UTF-8 and pass through.
+size_t plainPrefix(std::string_view s) {
+    size_t i = 0;
+    for (; i + sizeof(Bytes) <= s.size(); i += sizeof(Bytes)) {
+        Bytes v;
+        std::memcpy(&v, s.data() + i, sizeof(v));
+        auto special = (v < 0x20) | (v == '"') | (v == '\\');
+        uint64_t lanes[2];
+        std::memcpy(lanes, &special, sizeof(lanes));
+        if (lanes[0] | lanes[1]) break;
+    }
+    for (; i < s.size(); ++i) {
+        unsigned char c = s[i];
+        if (c < 0x20 || c == '"' || c == '\\') break;
+    }
+    return i;
+}
+
+// -------------------- WRITER --------------------
+
+class JsonWriter {
+public:
+    JsonWriter(JsonSink sink, void* context) : sink_(sink), context_(context) {}
+
+    // One member of the object being written
+    template <class T>
+    void operator()(std::string_view key, const T& v) {
+        name(key);
+        value(v);
+    }
+
+    template <class T>
+    void object(std::string_view key, const T& v) {
+        name(key);
+        members(v);
+    }
+
+    template <class T, class A>
+    void list(std::string_view key, const std::vector<T, A>& v) {
+        name(key);
+        put('[');
+        for (size_t i = 0; i < v.size(); ++i) {
+            if (i) put(',');
+            if constexpr (wire::isString<T> || std::is_arithmetic_v<T>)
+                value(v[i]);
+            else
+                members(v[i]);
+        }
+        put(']');
+    }
+
+    template <class T>
+    void members(const T& v) {
+        put('{');
+        first_ = true;
+        visit(*this, v);
+        put('}');
+        first_ = false;
+    }
+
+    void flush() {
+        if (len_) sink_(context_, std::string_view(buf_, len_));
+        len_ = 0;
+    }
+
+    void put(char c) {
+        if (len_ == sizeof(buf_)) flush();
+        buf_[len_++] = c;
+    }
+
+    void raw(std::string_view s) {
+        if (s.size() > sizeof(buf_) - len_) {
+            flush();
+            // Too big to be worth copying
+            if (s.size() >= sizeof(buf_)) {
+                sink_(context_, s);
+                return;
+            }
+        }
+        std::memcpy(buf_ + len_, s.data(), s.size());
+        len_ += s.size();
+    }
+
+private:
+    void name(std::string_view key) {
+        if (!first_) put(',');
+        first_ = false;
+        put('"');
+        raw(key);
+        raw("\":");
+    }
+
+    template <class T>
+    void value(const T& v) {
+        if constexpr (wire::isString<T> || std::is_same_v<T, Atom>) {
+            string(v);
+        } else if constexpr (std::is_same_v<T, bool>) {
+            raw(v ? "true" : "false");
+        } else if constexpr (std::is_floating_point_v<T>) {
+            if (!std::isfinite(v))
+                raw("null");
+            else
+                number(v);
+        } else {
+            number(v);
+        }
+    }
+
+    // Shortest text that reads back as the same value
+    template <class T>
+    void number(T v) {
+        if (sizeof(buf_) - len_ < kMaxNumber) flush();
+        len_ = std::to_chars(buf_ + len_, buf_ + sizeof(buf_), v).ptr - buf_;
+    }
+
+    void string(std::string_view s) {
+        put('"');
+        while (!s.empty()) {
+            size_t plain = plainPrefix(s);
+            raw(s.substr(0, plain));
+            if (plain == s.size()) break;
+            escape(static_cast<unsigned char>(s[plain]));
+            s.remove_prefix(plain + 1);
+        }
+        put('"');
+    }
+
+    void escape(unsigned char c) {
+        switch (c) {
+        case '"':  raw("\\\""); return;
+        case '\\': raw("\\\\"); return;
+        case '\b': raw("\\b"); return;
+        case '\f': raw("\\f"); return;
+        case '\n': raw("\\n"); return;
+        case '\r': raw("\\r"); return;
+        case '\t': raw("\\t"); return;
+        default: break;
+        }
+        static constexpr char hex[] = "0123456789abcdef";
+        char u[] = {'\\', 'u', '0', '0', hex[c >> 4], hex[c & 0xf]};
+        raw(std::string_view(u, sizeof(u)));
+    }
+
+    // Longest to_chars output: a negative double in exponent form
+    static constexpr size_t kMaxNumber = 32;
+
+    JsonSink sink_;
+    void* context_;
+    char buf_[4096];
+    size_t len_ = 0;
+    bool first_ = true;  // No member written yet in the current object
+};
+
+// -------------------- SCHEMA --------------------
+
+using wire::Of;
+
+template <class IO, class T> requires Of<T, Display>
+void visit(IO& io, T& d) {
+    io("name", d.name); io("width", d.width); io("height", d.height); io("refresh_rate", d.refresh_rate);
+    io("size_inches", d.size_inches); io("is_builtin", d.is_builtin); io("output_name", d.output_name);
+    io("current_mode", d.current_mode);
+}
+
+template <class IO, class T> requires Of<T, Disk>
+void visit(IO& io, T& d) {
+    io("mount_point", d.mount_point); io("filesystem", d.filesystem); io("total_bytes", d.total_bytes);
+    io("used_bytes", d.used_bytes); io("available_bytes", d.available_bytes); io("free_bytes", d.free_bytes);
+    io("usage_percent", d.usage_percent);
+}
+
+template <class IO, class T> requires Of<T, NetworkInterface>
+void visit(IO& io, T& n) {
+    io("name", n.name); io("ipv4", n.ipv4); io("ipv6", n.ipv6); io("mac", n.mac);
+    io("subnet_mask", n.subnet_mask); io("is_up", n.is_up); io("is_wireless", n.is_wireless);
+    io("operstate", n.operstate); io.list("ipv4_addresses", n.ipv4_addresses);
+    io("ifindex", n.ifindex); io("mtu", n.mtu);
+    io("rx_bytes", n.rx_bytes); io("tx_bytes", n.tx_bytes); io("rx_packets", n.rx_packets);
+    io("tx_packets", n.tx_packets); io("rx_errors", n.rx_errors); io("tx_errors", n.tx_errors);
+    io("rx_dropped", n.rx_dropped); io("tx_dropped", n.tx_dropped);
+}
+
+template <class IO, class T> requires Of<T, Battery>
+void visit(IO& io, T& b) {
+    io("name", b.name); io("percentage", b.percentage); io("status", b.status);
+    io("is_charging", b.is_charging); io("ac_connected", b.ac_connected);
+    io("time_remaining_mins", b.time_remaining_mins); io("voltage", b.voltage);
+    io("capacity_mah", b.capacity_mah);
+}
+
+template <class IO, class T> requires Of<T, GPU>
+void visit(IO& io, T& g) {
+    io("model", g.model); io("vendor", g.vendor); io("driver", g.driver); io("freq_ghz", g.freq_ghz);
+    io("memory_mb", g.memory_mb); io("is_integrated", g.is_integrated); io("temperature", g.temperature);
+}
+
+template <class IO, class T> requires Of<T, CPUMetrics>
+void visit(IO& io, T& m) {
+    io.list("freq_ghz", m.freq_ghz); io.list("temp_c", m.temp_c); io.list("utilization", m.utilization);
+    io.list("online", m.online); io.list("package", m.package); io.list("core", m.core);
+    io.list("node", m.node);
+}
+
+template <class IO, class T> requires Of<T, CPU>
+void visit(IO& io, T& c) {
+    io("model", c.model); io("vendor", c.vendor); io("core_count", c.core_count);
+    io("thread_count", c.thread_count); io("max_freq_ghz", c.max_freq_ghz);
+    io("current_freq_ghz", c.current_freq_ghz); io("architecture", c.architecture);
+    io.object("per_cpu", c.per_cpu);
+}
+
+template <class IO, class T> requires Of<T, Memory>
+void visit(IO& io, T& m) {
+    io("total_bytes", m.total_bytes); io("used_bytes", m.used_bytes); io("available_bytes", m.available_bytes);
+    io("free_bytes", m.free_bytes); io("cached_bytes", m.cached_bytes); io("buffers_bytes", m.buffers_bytes);
+    io("usage_percent", m.usage_percent);
+}
+
+template <class IO, class T> requires Of<T, Swap>
+void visit(IO& io, T& s) {
+    io("total_bytes", s.total_bytes); io("used_bytes", s.used_bytes); io("free_bytes", s.free_bytes);
+    io("usage_percent", s.usage_percent);
+}
+
+template <class IO, class T> requires Of<T, DesktopEnvironment>
+void visit(IO& io, T& de) {
+    io("name", de.name); io("version", de.version); io("wm_name", de.wm_name);
+    io("wm_protocol", de.wm_protocol); io("theme", de.theme); io("wm_theme", de.wm_theme);
+    io("icon_theme", de.icon_theme); io("cursor_theme", de.cursor_theme); io("cursor_size", de.cursor_size);
+    io("font_name", de.font_name); io("font_size", de.font_size);
+}
+
+template <class IO, class T> requires Of<T, PackageInfo>
+void visit(IO& io, T& p) {
+    io("manager_name", p.manager_name); io("count", p.count);
+}
+
+template <class IO, class T> requires Of<T, Info>
+void visit(IO& io, T& info) {
+    io("username", info.username); io("hostname", info.hostname); io("os_name", info.os_name);
+    io("os_version", info.os_version); io("os_codename", info.os_codename); io("os_id", info.os_id);
+    io("kernel", info.kernel); io("kernel_version", info.kernel_version);
+    io("architecture", info.architecture);
+
+    io("model", info.model); io("manufacturer", info.manufacturer); io("bios_version", info.bios_version);
+    io("board_name", info.board_name); io("chassis_type", info.chassis_type);
+
+    io("shell", info.shell); io("shell_version", info.shell_version);
+    io("terminal", info.terminal); io("terminal_version", info.terminal_version);
+
+    io("uptime_seconds", info.uptime_seconds); io("boot_time", info.boot_time);
+    io("current_time", info.current_time); io("locale", info.locale); io("timezone", info.timezone);
+
+    io.object("cpu", info.cpu); io.list("gpus", info.gpus);
+    io.object("memory", info.memory); io.object("swap", info.swap);
+    io.list("displays", info.displays); io.list("disks", info.disks);
+    io.list("network_interfaces", info.network_interfaces); io.list("batteries", info.batteries);
+    io.object("de", info.de); io.list("packages", info.packages);
+
+    io("total_packages", info.total_packages); io("package_managers", info.package_managers);
+    io.list("unavailable", info.unavailable); io.list("parse_errors", info.parse_errors);
+}
+
+} // namespace
+
+// -------------------- JSON --------------------
+
+template <class Alloc>
+void writeJson(const BasicInfo<Alloc>& info, JsonSink sink, void* context) {
+    JsonWriter out(sink, context);
+    out.members(info);
+    out.put('\n');
+    out.flush();
+}
+
+template void writeJson(const Info&, JsonSink, void*);
+template void writeJson(const ArenaInfo&, JsonSink, void*);
+
+} // namespace SystemInfo
@@ -0,0 +1,29 @@
+#pragma once
+#include "sysinfo.hpp"
+#include <memory>
+#include <string_view>
+
+namespace SystemInfo {
+
+// Info as one JSON object, formatted through a fixed buffer straight into
+// a sink: no document tree and no intermediate strings, so writing it
+// allocates nothing. Keys are the field names of sysinfo.hpp; unknown
+// readings (NaN) are null.
+
+// Receives the output a buffer at a time. A chunk is only valid during
+// the call.
+using JsonSink = void (*)(void* context, std::string_view chunk);
+
+template <class Alloc>
+void writeJson(const BasicInfo<Alloc>& info, JsonSink sink, void* context);
+
+// Any callable that takes a std::string_view
+template <class Alloc, class F>
+void writeJson(const BasicInfo<Alloc>& info, F&& sink) {
+    auto* f = std::addressof(sink);
+    writeJson(
+        info, [](void* context, std::string_view chunk) { (*static_cast<decltype(f)>(context))(chunk); },
+        const_cast<void*>(static_cast<const void*>(f)));
+}
+
+} // namespace SystemInfo
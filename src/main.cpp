@@ -3,6 +3,9 @@
 #include <windows.h>
 #else
 #include "sysinfo.hpp"
+#include "daemon.hpp"
+#include "snapshot.hpp"
+#include "json.hpp"
 #endif
 #include <iostream>
 #include <iomanip>
@@ -11,6 +14,12 @@
 #include <algorithm>
 #include <map>
 #include <filesystem>
+#include <cstdlib>
+#include <cctype>
+#if !defined(_WIN32) && !defined(_WIN64)
+#include <csignal>
+#include <ctime>
+#endif
 
 using namespace SystemInfo;
 using namespace std;
@@ -77,9 +86,9 @@ namespace LogoDatabase
     }
 }
 
-string getOSLogo(const string &os_name)
+string getOSLogo(string_view os_name)
 {
-    string os_lower = os_name;
+    string os_lower(os_name);
     transform(os_lower.begin(), os_lower.end(), os_lower.begin(), ::tolower);
 
     string logoColor = Colors::CYAN;
@@ -102,7 +111,7 @@ string getOSLogo(const string &os_name)
     else if (os_lower.find("nixos") != string::npos)
         logoColor = Colors::SKY;
 
-    int logoIndex = LogoDatabase::getDistroLogoIndex(os_name);
+    int logoIndex = LogoDatabase::getDistroLogoIndex(string(os_name));
     return LogoDatabase::getLogo(logoIndex, logoColor);
 }
 
@@ -123,72 +132,72 @@ string createProgressBar(int percentage, int width = 20)
     return bar.str();
 }
 
-void printInfo(const Info &info)
+void printInfo(const Info &info, ostream &out = cout, bool live = false)
 {
-    cout << "\n";
-    cout << Colors::PINK << "╭─────────────────────────────────────────────╮\n";
-    cout << Colors::LAVENDER << "│  " << Colors::BOLD << "✨ S Y S T E M   I N F O R M A T I O N ✨"
+    out << "\n";
+    out << Colors::PINK << "╭─────────────────────────────────────────────╮\n";
+    out << Colors::LAVENDER << "│  " << Colors::BOLD << "✨ S Y S T E M   I N F O R M A T I O N ✨"
          << Colors::RESET << Colors::LAVENDER << "  │\n";
-    cout << Colors::MINT << "╰─────────────────────────────────────────────╯\n"
+    out << Colors::MINT << "╰─────────────────────────────────────────────╯\n"
          << Colors::RESET;
-    cout << "\n";
+    out << "\n";
 
-    cout << getOSLogo(info.os_name) << "\n";
+    out << getOSLogo(info.os_name) << "\n";
 
     // User@Host
     if (!info.username.empty() || !info.hostname.empty())
     {
-        cout << Colors::LABEL << "👤 User" << Colors::DIM << " ········· " << Colors::RESET;
-        cout << Colors::PINK << Colors::BOLD;
+        out << Colors::LABEL << "👤 User" << Colors::DIM << " ········· " << Colors::RESET;
+        out << Colors::PINK << Colors::BOLD;
         if (!info.username.empty())
-            cout << info.username;
+            out << info.username;
         if (!info.hostname.empty())
-            cout << Colors::ACCENT << "@" << Colors::PINK << info.hostname;
-        cout << Colors::RESET << "\n";
+            out << Colors::ACCENT << "@" << Colors::PINK << info.hostname;
+        out << Colors::RESET << "\n";
     }
 
     // OS
     if (!info.os_name.empty())
     {
-        cout << Colors::LABEL << "🖥️  OS" << Colors::DIM << " ············ " << Colors::RESET;
-        cout << Colors::LAVENDER << info.os_name;
+        out << Colors::LABEL << "🖥️  OS" << Colors::DIM << " ············ " << Colors::RESET;
+        out << Colors::LAVENDER << info.os_name;
         if (!info.architecture.empty())
-            cout << " " << Colors::DIM << info.architecture << Colors::RESET;
-        cout << "\n";
+            out << " " << Colors::DIM << info.architecture << Colors::RESET;
+        out << "\n";
     }
 
     // Host
     if (!info.model.empty())
     {
-        cout << Colors::LABEL << "💻 Host" << Colors::DIM << " ········· " << Colors::RESET;
-        cout << Colors::PEACH << info.model << Colors::RESET << "\n";
+        out << Colors::LABEL << "💻 Host" << Colors::DIM << " ········· " << Colors::RESET;
+        out << Colors::PEACH << info.model << Colors::RESET << "\n";
     }
 
     // Kernel
     if (!info.kernel.empty())
     {
-        cout << Colors::LABEL << "⚙️  Kernel" << Colors::DIM << " ······· " << Colors::RESET;
-        cout << Colors::SKY << info.kernel << Colors::RESET << "\n";
+        out << Colors::LABEL << "⚙️  Kernel" << Colors::DIM << " ······· " << Colors::RESET;
+        out << Colors::SKY << info.kernel << Colors::RESET << "\n";
     }
 
     // Uptime
     if (info.uptime_seconds > 0)
     {
-        cout << Colors::LABEL << "⏱️  Uptime" << Colors::DIM << " ······· " << Colors::RESET;
-        cout << Colors::ROSE << formatUptime(info.uptime_seconds) << Colors::RESET << "\n";
+        out << Colors::LABEL << "⏱️  Uptime" << Colors::DIM << " ······· " << Colors::RESET;
+        out << Colors::ROSE << formatUptime(info.uptime_seconds) << Colors::RESET << "\n";
     }
 
     // Packages
     // if (info.total_packages > 0) {
-    //     cout << Colors::LABEL << "📦 Packages" << Colors::DIM << " ····· " << Colors::RESET;
-    //     cout << Colors::MINT << info.package_managers << Colors::RESET << "\n";
+    //     out << Colors::LABEL << "📦 Packages" << Colors::DIM << " ····· " << Colors::RESET;
+    //     out << Colors::MINT << info.package_managers << Colors::RESET << "\n";
     // }
 
     // Shell
     if (!info.shell.empty())
     {
-        cout << Colors::LABEL << "🐚 Shell" << Colors::DIM << " ········ " << Colors::RESET;
-        cout << Colors::MINT << info.shell << Colors::RESET << "\n";
+        out << Colors::LABEL << "🐚 Shell" << Colors::DIM << " ········ " << Colors::RESET;
+        out << Colors::MINT << info.shell << Colors::RESET << "\n";
     }
 
     // Display
@@ -196,103 +205,110 @@ void printInfo(const Info &info)
     {
         for (const auto &display : info.displays)
         {
-            cout << Colors::LABEL << "🖼️  Display" << Colors::DIM << " ······ " << Colors::RESET;
-            cout << Colors::PEACH << display.width << "×" << display.height;
+            out << Colors::LABEL << "🖼️  Display" << Colors::DIM << " ······ " << Colors::RESET;
+            out << Colors::PEACH << display.width << "×" << display.height;
             if (display.size_inches > 0)
             {
-                cout << " in " << fixed << setprecision(0) << display.size_inches << "\"";
+                out << " in " << fixed << setprecision(0) << display.size_inches << "\"";
             }
             if (display.refresh_rate > 0)
-                cout << ", " << display.refresh_rate << " Hz";
+                out << ", " << display.refresh_rate << " Hz";
             if (display.is_builtin)
-                cout << " " << Colors::DIM << "[Built-in]" << Colors::RESET;
-            cout << Colors::RESET << "\n";
+                out << " " << Colors::DIM << "[Built-in]" << Colors::RESET;
+            out << Colors::RESET << "\n";
         }
     }
 
     // DE & WM (combined for brevity)
     if (!info.de.name.empty())
     {
-        cout << Colors::LABEL << "🎨 DE" << Colors::DIM << " ············ " << Colors::RESET;
-        cout << Colors::LAVENDER << info.de.name << Colors::RESET << "\n";
+        out << Colors::LABEL << "🎨 DE" << Colors::DIM << " ············ " << Colors::RESET;
+        out << Colors::LAVENDER << info.de.name << Colors::RESET << "\n";
     }
 
     if (!info.de.wm_name.empty())
     {
-        cout << Colors::LABEL << "🪟 WM" << Colors::DIM << " ············ " << Colors::RESET;
-        cout << Colors::SKY << info.de.wm_name;
+        out << Colors::LABEL << "🪟 WM" << Colors::DIM << " ············ " << Colors::RESET;
+        out << Colors::SKY << info.de.wm_name;
         if (!info.de.wm_protocol.empty())
         {
-            cout << " " << Colors::DIM << info.de.wm_protocol << Colors::RESET;
+            out << " " << Colors::DIM << info.de.wm_protocol << Colors::RESET;
         }
-        cout << "\n";
+        out << "\n";
     }
 
     // Terminal
     if (!info.terminal.empty())
     {
-        cout << Colors::LABEL << "💻 Terminal" << Colors::DIM << " ····· " << Colors::RESET;
-        cout << Colors::SKY << info.terminal;
+        out << Colors::LABEL << "💻 Terminal" << Colors::DIM << " ····· " << Colors::RESET;
+        out << Colors::SKY << info.terminal;
         if (!info.terminal_version.empty())
-            cout << " " << info.terminal_version;
-        cout << Colors::RESET << "\n";
+            out << " " << info.terminal_version;
+        out << Colors::RESET << "\n";
     }
 
-    cout << "\n"
+    out << "\n"
          << Colors::DIM << "─ ─ ─ ─ ─ ─ ─ ─ ─ ─ ─ ─ ─ ─ ─ ─ ─ ─ ─ ─\n"
          << Colors::RESET << "\n";
 
     // CPU
     if (!info.cpu.model.empty())
     {
-        cout << Colors::LABEL << "🔧 CPU" << Colors::DIM << " ············ " << Colors::RESET;
-        cout << Colors::ROSE << info.cpu.model;
+        out << Colors::LABEL << "🔧 CPU" << Colors::DIM << " ············ " << Colors::RESET;
+        out << Colors::ROSE << info.cpu.model;
         if (info.cpu.thread_count > 0)
-            cout << " (" << info.cpu.thread_count << ")";
-        if (info.cpu.max_freq_ghz > 0)
+            out << " (" << info.cpu.thread_count << ")";
+        if (live && info.cpu.current_freq_ghz > 0)
         {
-            cout << " @ " << fixed << setprecision(2) << info.cpu.max_freq_ghz << " GHz";
+            out << " @ " << fixed << setprecision(2) << info.cpu.current_freq_ghz;
+            if (info.cpu.max_freq_ghz > 0)
+                out << " / " << info.cpu.max_freq_ghz;
+            out << " GHz";
         }
-        cout << Colors::RESET << "\n";
+        else if (info.cpu.max_freq_ghz > 0)
+        {
+            out << " @ " << fixed << setprecision(2) << info.cpu.max_freq_ghz << " GHz";
+        }
+        out << Colors::RESET << "\n";
     }
 
     // GPU
     for (const auto &gpu : info.gpus)
     {
-        cout << Colors::LABEL << "🎮 GPU" << Colors::DIM << " ············ " << Colors::RESET;
-        cout << Colors::LILAC << gpu.model;
+        out << Colors::LABEL << "🎮 GPU" << Colors::DIM << " ············ " << Colors::RESET;
+        out << Colors::LILAC << gpu.model;
         if (gpu.freq_ghz > 0)
         {
-            cout << " @ " << fixed << setprecision(2) << gpu.freq_ghz << " GHz";
+            out << " @ " << fixed << setprecision(2) << gpu.freq_ghz << " GHz";
         }
         if (gpu.is_integrated)
         {
-            cout << " " << Colors::DIM << "[Integrated]" << Colors::RESET;
+            out << " " << Colors::DIM << "[Integrated]" << Colors::RESET;
         }
-        cout << Colors::RESET << "\n";
+        out << Colors::RESET << "\n";
     }
 
     // Memory
     if (info.memory.total_bytes > 0)
     {
-        cout << Colors::LABEL << "💾 Memory" << Colors::DIM << " ······· " << Colors::RESET;
-        cout << Colors::CYAN << formatMemory(info.memory.used_bytes) << " / "
+        out << Colors::LABEL << "💾 Memory" << Colors::DIM << " ······· " << Colors::RESET;
+        out << Colors::CYAN << formatMemory(info.memory.used_bytes) << " / "
              << formatMemory(info.memory.total_bytes);
-        cout << " " << Colors::DIM << "(" << info.memory.usage_percent << "%)" << Colors::RESET << "\n";
-        cout << Colors::DIM << "                  " << Colors::RESET
+        out << " " << Colors::DIM << "(" << info.memory.usage_percent << "%)" << Colors::RESET << "\n";
+        out << Colors::DIM << "                  " << Colors::RESET
              << createProgressBar(info.memory.usage_percent) << "\n";
     }
 
     // Swap
     if (info.swap.total_bytes > 0)
     {
-        cout << Colors::LABEL << "💿 Swap" << Colors::DIM << " ·········· " << Colors::RESET;
-        cout << Colors::PEACH << formatMemory(info.swap.used_bytes) << " / "
+        out << Colors::LABEL << "💿 Swap" << Colors::DIM << " ·········· " << Colors::RESET;
+        out << Colors::PEACH << formatMemory(info.swap.used_bytes) << " / "
              << formatMemory(info.swap.total_bytes);
-        cout << " " << Colors::DIM << "(" << info.swap.usage_percent << "%)" << Colors::RESET << "\n";
+        out << " " << Colors::DIM << "(" << info.swap.usage_percent << "%)" << Colors::RESET << "\n";
         if (info.swap.usage_percent > 0)
         {
-            cout << Colors::DIM << "                  " << Colors::RESET
+            out << Colors::DIM << "                  " << Colors::RESET
                  << createProgressBar(info.swap.usage_percent) << "\n";
         }
     }
@@ -300,80 +316,299 @@ void printInfo(const Info &info)
     // Disks
     for (const auto &disk : info.disks)
     {
-        cout << Colors::LABEL << "💾 Disk" << Colors::DIM << " (" << disk.mount_point << ")"
+        out << Colors::LABEL << "💾 Disk" << Colors::DIM << " (" << disk.mount_point << ")"
              << string(max(0, 7 - (int)disk.mount_point.length()), ' ') << " " << Colors::RESET;
-        cout << Colors::MINT << formatBytes(disk.used_bytes) << " / "
+        out << Colors::MINT << formatBytes(disk.used_bytes) << " / "
              << formatBytes(disk.total_bytes);
-        cout << " " << Colors::DIM << "(" << disk.usage_percent << "%) - "
+        out << " " << Colors::DIM << "(" << disk.usage_percent << "%) - "
              << disk.filesystem << Colors::RESET << "\n";
     }
 
-    cout << "\n"
+    out << "\n"
          << Colors::DIM << "─ ─ ─ ─ ─ ─ ─ ─ ─ ─ ─ ─ ─ ─ ─ ─ ─ ─ ─ ─\n"
          << Colors::RESET << "\n";
 
     // Network
     for (const auto &net : info.network_interfaces)
     {
-        cout << Colors::LABEL << "🌐 Network" << Colors::DIM << " (" << net.name << ")"
+        out << Colors::LABEL << "🌐 Network" << Colors::DIM << " (" << net.name << ")"
              << string(max(0, 5 - (int)net.name.length()), ' ') << " " << Colors::RESET;
-        cout << Colors::SKY;
+        out << Colors::SKY;
         if (!net.ipv4.empty())
         {
-            cout << net.ipv4;
+            out << net.ipv4;
             if (!net.ipv6.empty())
-                cout << ", " << net.ipv6;
+                out << ", " << net.ipv6;
         }
         else if (!net.ipv6.empty())
         {
-            cout << net.ipv6;
+            out << net.ipv6;
         }
         if (net.is_wireless)
         {
-            cout << " " << Colors::DIM << "[Wireless]" << Colors::RESET;
+            out << " " << Colors::DIM << "[Wireless]" << Colors::RESET;
         }
-        cout << Colors::RESET << "\n";
+        out << Colors::RESET << "\n";
     }
 
     // Battery
     for (const auto &battery : info.batteries)
     {
-        cout << Colors::LABEL << "🔋 Battery" << Colors::DIM << " (" << battery.name << ")"
+        out << Colors::LABEL << "🔋 Battery" << Colors::DIM << " (" << battery.name << ")"
              << string(max(0, 3 - (int)battery.name.length()), ' ') << " " << Colors::RESET;
 
         string batteryColor = battery.percentage > 50 ? Colors::MINT : battery.percentage > 20 ? Colors::PEACH
                                                                                                : Colors::ROSE;
-        cout << batteryColor << battery.percentage << "%";
-        cout << " [" << battery.status;
+        out << batteryColor << battery.percentage << "%";
+        out << " [" << battery.status;
         if (battery.ac_connected)
-            cout << ", AC Connected";
-        cout << "]" << Colors::RESET << "\n";
-        cout << Colors::DIM << "                  " << Colors::RESET
+            out << ", AC Connected";
+        out << "]" << Colors::RESET << "\n";
+        out << Colors::DIM << "                  " << Colors::RESET
              << createProgressBar(battery.percentage) << "\n";
     }
 
     // Locale
     if (!info.locale.empty())
     {
-        cout << Colors::LABEL << "🌍 Locale" << Colors::DIM << " ······· " << Colors::RESET;
-        cout << Colors::LAVENDER << info.locale << Colors::RESET << "\n";
+        out << Colors::LABEL << "🌍 Locale" << Colors::DIM << " ······· " << Colors::RESET;
+        out << Colors::LAVENDER << info.locale << Colors::RESET << "\n";
+    }
+
+#if !defined(_WIN32) && !defined(_WIN64)
+    // Sections dropped by --deadline, and mounts that did not answer
+    if (!info.unavailable.empty())
+    {
+        out << Colors::LABEL << "⌛ Timed out" << Colors::DIM << " ···· " << Colors::RESET;
+        out << Colors::ROSE;
+        for (size_t i = 0; i < info.unavailable.size(); ++i)
+            out << (i ? ", " : "") << info.unavailable[i];
+        out << Colors::RESET << "\n";
     }
 
-    cout << "\n"
+    // Values the kernel handed over in a shape we could not read
+    for (const auto& error : info.parse_errors)
+    {
+        out << Colors::LABEL << "❗ Unparsed" << Colors::DIM << " ····· " << Colors::RESET;
+        out << Colors::ROSE << error << Colors::RESET << "\n";
+    }
+#endif
+
+    out << "\n"
          << Colors::DIM << "╭─────────────────────────────────────────────────╮" << Colors::RESET << "\n";
-    cout << Colors::DIM << "│" << Colors::RESET;
-    cout << "  " << Colors::PINK << "✧" << Colors::PEACH << "･ﾟ" << Colors::MINT << ": *" << Colors::SKY << "✧"
+    out << Colors::DIM << "│" << Colors::RESET;
+    out << "  " << Colors::PINK << "✧" << Colors::PEACH << "･ﾟ" << Colors::MINT << ": *" << Colors::SKY << "✧"
          << Colors::LAVENDER << "･ﾟ" << Colors::ROSE << ":* "
          << Colors::ACCENT << "Have a wonderful day!" << Colors::RESET << " "
          << Colors::ROSE << "*:" << Colors::LAVENDER << "･ﾟ" << Colors::SKY << "✧"
          << Colors::MINT << "*: " << Colors::PEACH << "･ﾟ" << Colors::PINK << "✧" << Colors::RESET
          << "  " << Colors::DIM << "│" << Colors::RESET << "\n";
-    cout << Colors::DIM << "╰─────────────────────────────────────────────────╯" << Colors::RESET << "\n\n";
+    out << Colors::DIM << "╰─────────────────────────────────────────────────╯" << Colors::RESET << "\n\n";
+}
+
+#if !defined(_WIN32) && !defined(_WIN64)
+void printTimings(const vector<Timing> &timings)
+{
+    auto micros = [](uint64_t ns)
+    {
+        stringstream out;
+        out << fixed << setprecision(3) << ns / 1000.0 << " µs";
+        return out.str();
+    };
+
+    cout << Colors::LABEL << "⏲️  Timings" << Colors::DIM
+         << "            wall           cpu   rw calls" << Colors::RESET << "\n";
+    for (const auto &t : timings)
+    {
+        cout << "   " << Colors::MINT << left << setw(14) << t.name << right << Colors::RESET
+             << Colors::VALUE << setw(15) << micros(t.wall_ns)
+             << setw(15) << micros(t.cpu_ns)
+             << setw(11) << t.rw_calls << Colors::RESET << "\n";
+    }
+    cout << "\n";
+}
+
+void printIOStats(const vector<IOStats> &stats)
+{
+    IOStats total;
+    total.name = "total";
+    for (const auto &s : stats)
+    {
+        total.opens += s.opens;
+        total.reads += s.reads;
+        total.stats += s.stats;
+        total.bytes += s.bytes;
+        total.dirents += s.dirents;
+    }
+
+    cout << Colors::LABEL << "📂 File I/O" << Colors::DIM
+         << "         opens   reads   stats       bytes   dirents" << Colors::RESET << "\n";
+    auto row = [](const IOStats &s)
+    {
+        cout << "   " << Colors::MINT << left << setw(14) << s.name << right << Colors::RESET
+             << Colors::VALUE << setw(8) << s.opens
+             << setw(8) << s.reads
+             << setw(8) << s.stats
+             << setw(12) << s.bytes
+             << setw(10) << s.dirents << Colors::RESET << "\n";
+    };
+    for (const auto &s : stats)
+        row(s);
+    row(total);
+    cout << "\n";
 }
 
+volatile sig_atomic_t watchStopped = 0;
+
+void onWatchSignal(int) { watchStopped = 1; }
+
+vector<string> splitLines(const string &text)
+{
+    vector<string> lines;
+    size_t start = 0, end;
+    while ((end = text.find('\n', start)) != string::npos)
+    {
+        lines.push_back(text.substr(start, end - start));
+        start = end + 1;
+    }
+    if (start < text.size())
+        lines.push_back(text.substr(start));
+    return lines;
+}
+
+// Escape sequences that turn the frame `before` into `after` on screen,
+// touching only the lines that differ. The cursor starts and ends on the
+// row below the frame, and moves relatively so a scrolled terminal is fine.
+string redrawLines(const vector<string> &before, const vector<string> &after)
+{
+    string out;
+    size_t row = before.size();
+    auto moveTo = [&](size_t target)
+    {
+        if (target < row)
+            out += "\033[" + to_string(row - target) + "A";
+        else if (target > row)
+            out += "\033[" + to_string(target - row) + "B";
+        out += '\r';
+        row = target;
+    };
+
+    size_t common = min(before.size(), after.size());
+    for (size_t i = 0; i < common; ++i)
+    {
+        if (before[i] == after[i])
+            continue;
+        moveTo(i);
+        out += after[i];
+        out += "\033[K";
+    }
+
+    if (after.size() != before.size())
+    {
+        // A battery or mount came or went: rewrite everything below it
+        moveTo(common);
+        out += "\033[J";
+        for (size_t i = common; i < after.size(); ++i)
+            out += after[i] + "\n";
+    }
+    else if (!out.empty())
+    {
+        moveTo(after.size());
+    }
+    return out;
+}
+
+// Live view for --watch: refreshes the volatile fields every interval and
+// rewrites only the lines that changed, so a tick costs a few dozen bytes
+// instead of the whole logo. Reports the bytes written when interrupted.
+int runWatch(const Flags &flags, unsigned intervalMs)
+{
+    struct sigaction sa{};
+    sa.sa_handler = onWatchSignal;
+    sigaction(SIGINT, &sa, nullptr);
+    sigaction(SIGTERM, &sa, nullptr);
+
+    Fetcher fetcher;
+    fetcher.fetchInfo(flags);
+
+    vector<string> shown;
+    size_t ticks = 0, frameBytes = 0, tickBytes = 0;
+    while (true)
+    {
+        ostringstream frame;
+        printInfo(fetcher.getInfo(), frame, true);
+        vector<string> lines = splitLines(frame.str());
+
+        if (ticks == 0)
+        {
+            string full = "\033[?25l" + frame.str();
+            frameBytes = full.size();
+            cout << full << flush;
+        }
+        else
+        {
+            string damage = redrawLines(shown, lines);
+            tickBytes += damage.size();
+            cout << damage << flush;
+        }
+        shown = std::move(lines);
+
+        // Interrupted by the signal handler, which is installed without SA_RESTART
+        timespec interval{static_cast<time_t>(intervalMs / 1000), static_cast<long>(intervalMs % 1000) * 1000000};
+        if (watchStopped || nanosleep(&interval, nullptr) != 0 || watchStopped)
+            break;
+        fetcher.refresh(flags);
+        ++ticks;
+    }
+
+    cout << "\033[?25h" << flush;
+    fprintf(stderr, "nacfetch: first frame %zu bytes, %zu updates, %zu bytes (%zu per update)\n",
+            frameBytes, ticks, tickBytes, ticks ? tickBytes / ticks : 0);
+    return 0;
+}
+
+enum class Output
+{
+    Text,
+    Json,     // --json, for config management and other tooling
+    Snapshot  // --snapshot, for collectors that ship it off the host
+};
+
+void writeInfo(const Info &info, Output output)
+{
+    switch (output)
+    {
+    case Output::Text:
+        printInfo(info);
+        break;
+    case Output::Json:
+        writeJson(info, [](string_view chunk)
+                  { fwrite(chunk.data(), 1, chunk.size(), stdout); });
+        break;
+    case Output::Snapshot:
+    {
+        string blob;
+        snapshot::write(info, blob);
+        fwrite(blob.data(), 1, blob.size(), stdout);
+        break;
+    }
+    }
+}
+#endif
+
 int main(int argc, char *argv[])
 {
     Flags flags;
+    #if !defined(_WIN32) && !defined(_WIN64)
+    flags.parallel = true;
+    flags.static_cache = true;
+    bool daemonMode = false;
+    bool watchMode = false;
+    bool useDaemon = true;
+    Output output = Output::Text;
+    unsigned refreshMs = 1000;
+    unsigned watchMs = 1000;
+    #endif
     #if defined(_WIN32) || defined(_WIN64)
     //     #include "sysinfo.win.hpp"
     //     #include <windows.h>
@@ -392,11 +627,128 @@ int main(int argc, char *argv[])
             cout << Colors::LABEL << "Options:\n"
                  << Colors::RESET;
             cout << "  " << Colors::MINT << "--help, -h" << Colors::RESET << "        Show this help\n";
+#if !defined(_WIN32) && !defined(_WIN64)
+            cout << "  " << Colors::MINT << "--sequential" << Colors::RESET << "      Run collectors one after another\n";
+            cout << "  " << Colors::MINT << "--deadline <ms>" << Colors::RESET << "   Give up on collectors still running after <ms>\n";
+            cout << "  " << Colors::MINT << "--timings" << Colors::RESET << "         Show the cost of every collector\n";
+            cout << "  " << Colors::MINT << "--stats" << Colors::RESET << "           Count the files every collector opens and reads\n";
+            cout << "  " << Colors::MINT << "--daemon [ms]" << Colors::RESET << "     Serve cached info to other runs, refreshing every [ms]\n";
+            cout << "  " << Colors::MINT << "--watch [ms]" << Colors::RESET << "      Live view, updating changed lines every [ms]\n";
+            cout << "  " << Colors::MINT << "--no-daemon" << Colors::RESET << "       Fetch locally even if a daemon is running\n";
+            cout << "  " << Colors::MINT << "--no-cache" << Colors::RESET << "        Re-read hardware facts instead of using the boot cache\n";
+            cout << "  " << Colors::MINT << "--json" << Colors::RESET << "            Write everything as JSON instead\n";
+            cout << "  " << Colors::MINT << "--snapshot" << Colors::RESET << "        Write a binary snapshot to stdout instead\n";
+#endif
             cout << "\n";
             return 0;
         }
+#if !defined(_WIN32) && !defined(_WIN64)
+        else if (arg == "--sequential")
+        {
+            flags.parallel = false;
+        }
+        else if (arg == "--deadline" && i + 1 < argc)
+        {
+            flags.deadline_us = strtoull(argv[++i], nullptr, 10) * 1000;
+        }
+        else if (arg == "--timings")
+        {
+            flags.timings = true;
+        }
+        else if (arg == "--stats")
+        {
+            flags.io_stats = true;
+        }
+        else if (arg == "--daemon")
+        {
+            daemonMode = true;
+            if (i + 1 < argc && isdigit(static_cast<unsigned char>(argv[i + 1][0])))
+                refreshMs = max(1ul, strtoul(argv[++i], nullptr, 10));
+        }
+        else if (arg == "--watch")
+        {
+            watchMode = true;
+            if (i + 1 < argc && isdigit(static_cast<unsigned char>(argv[i + 1][0])))
+                watchMs = max(1ul, strtoul(argv[++i], nullptr, 10));
+        }
+        else if (arg == "--no-daemon")
+        {
+            useDaemon = false;
+        }
+        else if (arg == "--no-cache")
+        {
+            flags.static_cache = false;
+        }
+        else if (arg == "--json")
+        {
+            output = Output::Json;
+        }
+        else if (arg == "--snapshot")
+        {
+            output = Output::Snapshot;
+        }
+#endif
     }
 
+#if !defined(_WIN32) && !defined(_WIN64)
+    if (daemonMode)
+        return runDaemon(daemonSocketPath(), refreshMs, flags);
+    if (watchMode)
+        return runWatch(flags, watchMs);
+
+    // A running daemon already holds the hardware and counters; the
+    // environment-derived sections belong to this process, not to it
+    Info served;
+    if (useDaemon && !flags.timings && !flags.io_stats && requestInfo(daemonSocketPath(), served))
+    {
+        Flags local;
+        local.os = local.kernel = local.model = local.cpu = local.gpu = false;
+        local.memory = local.swap = local.disk = local.display = false;
+        local.network = local.battery = local.packages = local.uptime = false;
+
+        // fetchInfo starts both lists afresh, but the daemon's entries are
+        // about the sections it served: put them back in front
+        auto unavailable = std::move(served.unavailable);
+        auto parse_errors = std::move(served.parse_errors);
+        Fetcher fetcher(std::move(served));
+        fetcher.fetchInfo(local);
+        Info info = fetcher.getInfo();
+        info.unavailable.insert(info.unavailable.begin(), unavailable.begin(), unavailable.end());
+        info.parse_errors.insert(info.parse_errors.begin(), parse_errors.begin(), parse_errors.end());
+        writeInfo(info, output);
+        return 0;
+    }
+
+    if (output != Output::Text)
+    {
+        Fetcher fetcher;
+        fetcher.fetchInfo(flags);
+        writeInfo(fetcher.getInfo(), output);
+        return 0;
+    }
+
+    if (flags.timings || flags.io_stats)
+    {
+        Stopwatch watch;
+        watch.start();
+        Fetcher fetcher;
+        fetcher.fetchInfo(flags);
+        vector<Timing> timings = fetcher.getTimings();
+        timings.push_back(watch.stop("fetchInfo"));
+
+        watch.start();
+        printInfo(fetcher.getInfo());
+        cout.flush();
+        timings.push_back(watch.stop("printInfo"));
+
+        if (flags.timings)
+            printTimings(timings);
+        if (flags.io_stats)
+            printIOStats(fetcher.getIOStats());
+        return 0;
+    }
+#endif
+
     Fetcher fetcher;
     fetcher.fetchInfo(flags);
     const Info &info = fetcher.getInfo();
@@ -0,0 +1,191 @@
+#include "netlink.hpp"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <iterator>
+#include <arpa/inet.h>
+#include <linux/if_link.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace SystemInfo {
+
+namespace {
+
+// A NETLINK_ROUTE socket that has sent one dump request
+class DumpSocket {
+public:
+    template <class Request>
+    explicit DumpSocket(Request& req) : fd_(socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC, NETLINK_ROUTE)) {
+        if (fd_ < 0) return;
+        req.nh.nlmsg_len = sizeof(req);
+        req.nh.nlmsg_flags = NLM_F_REQUEST | NLM_F_DUMP;
+        req.nh.nlmsg_seq = 1;
+        sockaddr_nl kernel{};
+        kernel.nl_family = AF_NETLINK;
+        if (sendto(fd_, &req, sizeof(req), 0, reinterpret_cast<sockaddr*>(&kernel), sizeof(kernel)) < 0) {
+            close(fd_);
+            fd_ = -1;
+        }
+    }
+    ~DumpSocket() { if (fd_ >= 0) close(fd_); }
+
+    DumpSocket(const DumpSocket&) = delete;
+    DumpSocket& operator=(const DumpSocket&) = delete;
+
+    // Calls fn(const nlmsghdr*) for every message of the reply. Returns
+    // true once the kernel has sent NLMSG_DONE.
+    template <class F>
+    bool forEach(F&& fn) {
+        if (fd_ < 0) return false;
+        alignas(nlmsghdr) char buf[32768];
+        for (;;) {
+            ssize_t n = recv(fd_, buf, sizeof(buf), 0);
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) return false;
+            int len = static_cast<int>(n);
+            for (auto* nh = reinterpret_cast<const nlmsghdr*>(buf); NLMSG_OK(nh, len); nh = NLMSG_NEXT(nh, len)) {
+                if (nh->nlmsg_type == NLMSG_DONE) return true;
+                if (nh->nlmsg_type == NLMSG_ERROR) return false;
+                fn(nh);
+            }
+        }
+    }
+
+private:
+    int fd_;
+};
+
+} // namespace
+
+// -------------------- LINKS --------------------
+
+// Same words as /sys/class/net/*/operstate
+static const char* operstateName(uint8_t state) {
+    static const char* const names[] = {"unknown", "notpresent", "down", "lowerlayerdown",
+                                        "testing", "dormant", "up"};
+    return state < std::size(names) ? names[state] : "unknown";
+}
+
+bool dumpLinks(std::vector<Link>& out) {
+    struct {
+        nlmsghdr nh;
+        ifinfomsg ifi;
+    } req{};
+    req.nh.nlmsg_type = RTM_GETLINK;
+    req.ifi.ifi_family = AF_UNSPEC;
+
+    DumpSocket sock(req);
+    return sock.forEach([&](const nlmsghdr* nh) {
+        if (nh->nlmsg_type != RTM_NEWLINK) return;
+        auto* ifi = static_cast<const ifinfomsg*>(NLMSG_DATA(nh));
+
+        Link link;
+        link.ifindex = ifi->ifi_index;
+        link.type = ifi->ifi_type;
+        link.flags = ifi->ifi_flags;
+        link.operstate = "unknown";
+
+        int len = static_cast<int>(IFLA_PAYLOAD(nh));
+        for (auto* rta = IFLA_RTA(ifi); RTA_OK(rta, len); rta = RTA_NEXT(rta, len)) {
+            const auto* data = static_cast<const unsigned char*>(RTA_DATA(rta));
+            size_t size = RTA_PAYLOAD(rta);
+            switch (rta->rta_type) {
+            case IFLA_IFNAME:
+                link.name.assign(reinterpret_cast<const char*>(data), strnlen(reinterpret_cast<const char*>(data), size));
+                break;
+            case IFLA_ADDRESS:
+                for (size_t i = 0; i < size; i++) {
+                    char hex[4];
+                    snprintf(hex, sizeof(hex), i ? ":%02x" : "%02x", data[i]);
+                    link.mac += hex;
+                }
+                break;
+            case IFLA_MTU:
+                if (size >= sizeof(uint32_t)) memcpy(&link.mtu, data, sizeof(uint32_t));
+                break;
+            case IFLA_OPERSTATE:
+                if (size >= 1) link.operstate = operstateName(data[0]);
+                break;
+            case IFLA_STATS64:
+                // Attribute data is only 4-byte aligned: copy it out
+                if (size >= sizeof(rtnl_link_stats64)) {
+                    rtnl_link_stats64 stats;
+                    memcpy(&stats, data, sizeof(stats));
+                    link.rx_bytes = stats.rx_bytes;
+                    link.tx_bytes = stats.tx_bytes;
+                    link.rx_packets = stats.rx_packets;
+                    link.tx_packets = stats.tx_packets;
+                    link.rx_errors = stats.rx_errors;
+                    link.tx_errors = stats.tx_errors;
+                    link.rx_dropped = stats.rx_dropped;
+                    link.tx_dropped = stats.tx_dropped;
+                }
+                break;
+            case IFLA_LINKINFO: {
+                int info_len = static_cast<int>(size);
+                for (auto* info = static_cast<const rtattr*>(RTA_DATA(rta)); RTA_OK(info, info_len);
+                     info = RTA_NEXT(info, info_len)) {
+                    if (info->rta_type == IFLA_INFO_KIND)
+                        link.kind.assign(static_cast<const char*>(RTA_DATA(info)),
+                                         strnlen(static_cast<const char*>(RTA_DATA(info)), RTA_PAYLOAD(info)));
+                }
+                break;
+            }
+            default: break;
+            }
+        }
+        out.push_back(std::move(link));
+    });
+}
+
+// -------------------- ADDRESSES --------------------
+
+bool dumpAddresses(std::vector<InterfaceAddress>& out) {
+    struct {
+        nlmsghdr nh;
+        ifaddrmsg ifa;
+    } req{};
+    req.nh.nlmsg_type = RTM_GETADDR;
+    req.ifa.ifa_family = AF_UNSPEC;
+
+    DumpSocket sock(req);
+    return sock.forEach([&](const nlmsghdr* nh) {
+        if (nh->nlmsg_type != RTM_NEWADDR) return;
+        auto* ifa = static_cast<const ifaddrmsg*>(NLMSG_DATA(nh));
+        if (ifa->ifa_family != AF_INET && ifa->ifa_family != AF_INET6) return;
+
+        InterfaceAddress addr;
+        addr.ifindex = static_cast<int>(ifa->ifa_index);
+        addr.family = ifa->ifa_family;
+        addr.prefix_len = ifa->ifa_prefixlen;
+        addr.scope = ifa->ifa_scope;
+        addr.flags = ifa->ifa_flags;
+
+        // IFA_LOCAL is the interface's own address; IFA_ADDRESS is the
+        // peer on point-to-point links and the same thing everywhere else
+        const void* local = nullptr;
+        const void* address = nullptr;
+        int len = static_cast<int>(IFA_PAYLOAD(nh));
+        for (auto* rta = IFA_RTA(ifa); RTA_OK(rta, len); rta = RTA_NEXT(rta, len)) {
+            switch (rta->rta_type) {
+            case IFA_LOCAL:   local = RTA_DATA(rta); break;
+            case IFA_ADDRESS: address = RTA_DATA(rta); break;
+            case IFA_FLAGS:   memcpy(&addr.flags, RTA_DATA(rta), sizeof(addr.flags)); break;
+            default: break;
+            }
+        }
+        if (!local) local = address;
+        if (!local) return;
+
+        char text[INET6_ADDRSTRLEN];
+        if (!inet_ntop(addr.family, local, text, sizeof(text))) return;
+        addr.address = text;
+        out.push_back(std::move(addr));
+    });
+}
+
+} // namespace SystemInfo
@@ -0,0 +1,54 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace SystemInfo {
+
+// rtnetlink dumps: the kernel's whole link or address table in one
+// request instead of a sysfs directory or /proc/net text file per
+// interface.
+
+// One address assigned to an interface, IPv4 or IPv6
+struct InterfaceAddress {
+    int ifindex = 0;
+    int family = 0;            // AF_INET or AF_INET6
+    unsigned prefix_len = 0;
+    unsigned scope = 0;        // RT_SCOPE_*
+    uint32_t flags = 0;        // IFA_F_*
+    std::string address;       // Printable, as inet_ntop writes it
+};
+
+// One network interface as RTM_GETLINK describes it
+struct Link {
+    int ifindex = 0;
+    unsigned type = 0;         // ARPHRD_*
+    unsigned flags = 0;        // IFF_*
+    std::string name;
+    std::string mac;           // Colon-separated hex, as sysfs prints it
+    std::string operstate;     // RFC 2863 state, as sysfs prints it
+    std::string kind;          // Driver kind of virtual links: veth, bridge, ...
+    uint32_t mtu = 0;
+
+    // IFLA_STATS64
+    uint64_t rx_bytes = 0;
+    uint64_t tx_bytes = 0;
+    uint64_t rx_packets = 0;
+    uint64_t tx_packets = 0;
+    uint64_t rx_errors = 0;
+    uint64_t tx_errors = 0;
+    uint64_t rx_dropped = 0;
+    uint64_t tx_dropped = 0;
+};
+
+// Every link with its counters, from one RTM_GETLINK dump. Returns false,
+// with `out` possibly partial, if rtnetlink is unavailable or the dump
+// fails.
+bool dumpLinks(std::vector<Link>& out);
+
+// Every address of every interface, from one RTM_GETADDR dump. Returns
+// false, with `out` possibly partial, if rtnetlink is unavailable or the
+// dump fails.
+bool dumpAddresses(std::vector<InterfaceAddress>& out);
+
+} // namespace SystemInfo
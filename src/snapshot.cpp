@@ -0,0 +1,378 @@
+#include "snapshot.hpp"
+#include "wire.hpp"
+
+namespace SystemInfo::snapshot {
+
+// -------------------- VIEW --------------------
+
+Record Record::at(std::string_view blob, uint64_t offset) {
+    if (offset + 8 > blob.size()) return Record();
+    uint32_t fields = detail::load<uint32_t>(blob.data() + offset);
+    if (offset + 8 + 8 * uint64_t(fields) > blob.size()) return Record();
+    return Record(blob, static_cast<uint32_t>(offset + 8), fields);
+}
+
+std::string_view Record::str(uint32_t f) const {
+    uint64_t s = u64(f);
+    uint64_t offset = s & 0xffffffff, size = s >> 32;
+    if (offset + size > blob_.size()) return {};
+    return blob_.substr(offset, size);
+}
+
+Record Record::record(uint32_t f) const {
+    return has(f) ? at(blob_, detail::load<uint32_t>(slot(f))) : Record();
+}
+
+List Record::list(uint32_t f) const {
+    if (!has(f)) return List();
+    uint64_t offset = detail::load<uint32_t>(slot(f));
+    if (offset + 8 > blob_.size()) return List();
+    uint32_t count = detail::load<uint32_t>(blob_.data() + offset);
+    uint32_t stride = detail::load<uint32_t>(blob_.data() + offset + 4);
+    // A zero stride would let a tiny blob claim billions of elements
+    if (count != 0 && stride == 0) return List();
+    if (offset + 8 + uint64_t(count) * stride > blob_.size()) return List();
+    return List(blob_, static_cast<uint32_t>(offset + 8), count, stride);
+}
+
+View::View(std::string_view blob) {
+    if (blob.size() < kHeaderSize) return;
+    const char* p = blob.data();
+    if (detail::load<uint32_t>(p) != kMagic) return;
+    version_ = detail::load<uint16_t>(p + 4);
+    uint16_t header_size = detail::load<uint16_t>(p + 6);
+    uint32_t size = detail::load<uint32_t>(p + 8);
+    if (version_ != kVersion || header_size < kHeaderSize || size < header_size || size > blob.size())
+        return;
+    blob_ = blob.substr(0, size);
+    root_ = Record::at(blob_, detail::load<uint32_t>(p + 12));
+    ok_ = true;
+}
+
+namespace {
+
+// -------------------- SCHEMA --------------------
+//
+// One visit() per struct, shared by Writer and Loader like those of
+// wire.hpp, with every field named by its slot.
+
+template <class T> constexpr uint32_t kFields = 0;
+template <class A> constexpr uint32_t kFields<BasicInfo<A>> = field::info::kCount;
+template <class A> constexpr uint32_t kFields<BasicCPU<A>> = field::cpu::kCount;
+template <class A> constexpr uint32_t kFields<BasicCPUMetrics<A>> = field::cpu_metrics::kCount;
+template <class A> constexpr uint32_t kFields<BasicGPU<A>> = field::gpu::kCount;
+template <> constexpr uint32_t kFields<Memory> = field::memory::kCount;
+template <> constexpr uint32_t kFields<Swap> = field::swap::kCount;
+template <class A> constexpr uint32_t kFields<BasicDisplay<A>> = field::display::kCount;
+template <class A> constexpr uint32_t kFields<BasicDisk<A>> = field::disk::kCount;
+template <class A> constexpr uint32_t kFields<BasicNetworkInterface<A>> = field::network_interface::kCount;
+template <class A> constexpr uint32_t kFields<BasicBattery<A>> = field::battery::kCount;
+template <class A> constexpr uint32_t kFields<BasicDesktopEnvironment<A>> = field::desktop_environment::kCount;
+template <class A> constexpr uint32_t kFields<BasicPackageInfo<A>> = field::package_info::kCount;
+
+using wire::Of;
+
+template <class IO, class T> requires Of<T, Display>
+void visit(IO& io, T& d) {
+    using namespace field::display;
+    io(name, d.name); io(width, d.width); io(height, d.height); io(refresh_rate, d.refresh_rate);
+    io(size_inches, d.size_inches); io(is_builtin, d.is_builtin); io(output_name, d.output_name);
+    io(current_mode, d.current_mode);
+}
+
+template <class IO, class T> requires Of<T, Disk>
+void visit(IO& io, T& d) {
+    using namespace field::disk;
+    io(mount_point, d.mount_point); io(filesystem, d.filesystem); io(total_bytes, d.total_bytes);
+    io(used_bytes, d.used_bytes); io(available_bytes, d.available_bytes); io(free_bytes, d.free_bytes);
+    io(usage_percent, d.usage_percent);
+}
+
+template <class IO, class T> requires Of<T, NetworkInterface>
+void visit(IO& io, T& n) {
+    using namespace field::network_interface;
+    io(name, n.name); io(ipv4, n.ipv4); io(ipv6, n.ipv6); io(mac, n.mac); io(subnet_mask, n.subnet_mask);
+    io(is_up, n.is_up); io(is_wireless, n.is_wireless); io(operstate, n.operstate);
+    io.list(ipv4_addresses, n.ipv4_addresses); io(ifindex, n.ifindex); io(mtu, n.mtu);
+    io(rx_bytes, n.rx_bytes); io(tx_bytes, n.tx_bytes); io(rx_packets, n.rx_packets);
+    io(tx_packets, n.tx_packets); io(rx_errors, n.rx_errors); io(tx_errors, n.tx_errors);
+    io(rx_dropped, n.rx_dropped); io(tx_dropped, n.tx_dropped);
+}
+
+template <class IO, class T> requires Of<T, Battery>
+void visit(IO& io, T& b) {
+    using namespace field::battery;
+    io(name, b.name); io(percentage, b.percentage); io(status, b.status);
+    io(is_charging, b.is_charging); io(ac_connected, b.ac_connected);
+    io(time_remaining_mins, b.time_remaining_mins); io(voltage, b.voltage); io(capacity_mah, b.capacity_mah);
+}
+
+template <class IO, class T> requires Of<T, GPU>
+void visit(IO& io, T& g) {
+    using namespace field::gpu;
+    io(model, g.model); io(vendor, g.vendor); io(driver, g.driver); io(freq_ghz, g.freq_ghz);
+    io(memory_mb, g.memory_mb); io(is_integrated, g.is_integrated); io(temperature, g.temperature);
+}
+
+template <class IO, class T> requires Of<T, CPUMetrics>
+void visit(IO& io, T& m) {
+    using namespace field::cpu_metrics;
+    io.list(freq_ghz, m.freq_ghz); io.list(temp_c, m.temp_c); io.list(utilization, m.utilization);
+    io.list(online, m.online); io.list(package, m.package); io.list(core, m.core); io.list(node, m.node);
+    // Arrays a blob cut short or lacks entirely
+    if constexpr (!std::is_const_v<T>) m.resize(m.size());
+}
+
+template <class IO, class T> requires Of<T, CPU>
+void visit(IO& io, T& c) {
+    using namespace field::cpu;
+    io(model, c.model); io(vendor, c.vendor); io(core_count, c.core_count); io(thread_count, c.thread_count);
+    io(max_freq_ghz, c.max_freq_ghz); io(current_freq_ghz, c.current_freq_ghz);
+    io(architecture, c.architecture); io.record(per_cpu, c.per_cpu);
+}
+
+template <class IO, class T> requires Of<T, Memory>
+void visit(IO& io, T& m) {
+    using namespace field::memory;
+    io(total_bytes, m.total_bytes); io(used_bytes, m.used_bytes); io(available_bytes, m.available_bytes);
+    io(free_bytes, m.free_bytes); io(cached_bytes, m.cached_bytes); io(buffers_bytes, m.buffers_bytes);
+    io(usage_percent, m.usage_percent);
+}
+
+template <class IO, class T> requires Of<T, Swap>
+void visit(IO& io, T& s) {
+    using namespace field::swap;
+    io(total_bytes, s.total_bytes); io(used_bytes, s.used_bytes); io(free_bytes, s.free_bytes);
+    io(usage_percent, s.usage_percent);
+}
+
+template <class IO, class T> requires Of<T, DesktopEnvironment>
+void visit(IO& io, T& de) {
+    using namespace field::desktop_environment;
+    io(name, de.name); io(version, de.version); io(wm_name, de.wm_name); io(wm_protocol, de.wm_protocol);
+    io(theme, de.theme); io(wm_theme, de.wm_theme); io(icon_theme, de.icon_theme);
+    io(cursor_theme, de.cursor_theme); io(cursor_size, de.cursor_size);
+    io(font_name, de.font_name); io(font_size, de.font_size);
+}
+
+template <class IO, class T> requires Of<T, PackageInfo>
+void visit(IO& io, T& p) {
+    using namespace field::package_info;
+    io(manager_name, p.manager_name); io(count, p.count);
+}
+
+template <class IO, class T> requires Of<T, Info>
+void visit(IO& io, T& info) {
+    using namespace field::info;
+    io(username, info.username); io(hostname, info.hostname); io(os_name, info.os_name);
+    io(os_version, info.os_version); io(os_codename, info.os_codename); io(os_id, info.os_id);
+    io(kernel, info.kernel); io(kernel_version, info.kernel_version); io(architecture, info.architecture);
+
+    io(model, info.model); io(manufacturer, info.manufacturer); io(bios_version, info.bios_version);
+    io(board_name, info.board_name); io(chassis_type, info.chassis_type);
+
+    io(shell, info.shell); io(shell_version, info.shell_version);
+    io(terminal, info.terminal); io(terminal_version, info.terminal_version);
+
+    io(uptime_seconds, info.uptime_seconds); io(boot_time, info.boot_time);
+    io(current_time, info.current_time); io(locale, info.locale); io(timezone, info.timezone);
+
+    io.record(cpu, info.cpu); io.list(gpus, info.gpus);
+    io.record(memory, info.memory); io.record(swap, info.swap);
+    io.list(displays, info.displays); io.list(disks, info.disks);
+    io.list(network_interfaces, info.network_interfaces); io.list(batteries, info.batteries);
+    io.record(de, info.de); io.list(packages, info.packages);
+
+    io(total_packages, info.total_packages); io(package_managers, info.package_managers);
+    io.list(unavailable, info.unavailable); io.list(parse_errors, info.parse_errors);
+}
+
+// -------------------- WRITER --------------------
+
+template <class T>
+uint64_t bits(T v) {
+    if constexpr (std::is_floating_point_v<T>) {
+        double d = v;
+        uint64_t out;
+        std::memcpy(&out, &d, sizeof(out));
+        return out;
+    } else {
+        return static_cast<uint64_t>(v);
+    }
+}
+
+// Lays each record or list out as one zeroed block, then fills in its
+// slots; strings and nested blocks go after it
+class Writer {
+public:
+    explicit Writer(std::string& out) : out_(out), base_(out.size()) {}
+
+    template <class Alloc>
+    void root(const BasicInfo<Alloc>& info) {
+        out_.append(kHeaderSize, '\0');
+        uint32_t at = block(kFields<Info>, 0, kFields<Info> * 8);
+        fill(at + 8, info);
+        align();
+        put(0, kMagic, 4);
+        put(4, kVersion, 2);
+        put(6, kHeaderSize, 2);
+        put(8, pos(), 4);
+        put(12, at, 4);
+    }
+
+    template <class T>
+    void operator()(uint32_t f, const T& v) {
+        if constexpr (wire::isString<T> || std::is_same_v<T, Atom>)
+            set(f, text(v));
+        else
+            set(f, bits(v));
+    }
+
+    template <class T>
+    void record(uint32_t f, const T& v) {
+        uint32_t at = block(kFields<T>, 0, kFields<T> * 8);
+        set(f, at);
+        fill(at + 8, v);
+    }
+
+    template <class T, class A>
+    void list(uint32_t f, const std::vector<T, A>& v) {
+        uint32_t count = static_cast<uint32_t>(v.size());
+        if constexpr (wire::isString<T>) {
+            uint32_t at = block(count, 8, count * 8);
+            set(f, at);
+            for (uint32_t i = 0; i < count; ++i)
+                put(at + 8 + 8 * i, text(v[i]), 8);
+        } else if constexpr (std::is_arithmetic_v<T>) {
+            uint32_t at = block(count, sizeof(T), count * sizeof(T));
+            set(f, at);
+            for (uint32_t i = 0; i < count; ++i) {
+                std::conditional_t<sizeof(T) == 4, uint32_t, uint8_t> raw;
+                static_assert(sizeof(raw) == sizeof(T), "per-CPU arrays hold 1- or 4-byte values");
+                std::memcpy(&raw, &v[i], sizeof(T));
+                put(at + 8 + i * sizeof(T), raw, sizeof(T));
+            }
+        } else {
+            constexpr uint32_t stride = kFields<T> * 8;
+            uint32_t at = block(count, stride, count * stride);
+            set(f, at);
+            for (uint32_t i = 0; i < count; ++i)
+                fill(at + 8 + i * stride, v[i]);
+        }
+    }
+
+private:
+    template <class T>
+    void fill(uint32_t slots, const T& v) {
+        uint32_t outer = slots_;
+        slots_ = slots;
+        visit(*this, v);
+        slots_ = outer;
+    }
+
+    // An aligned block: two u32 then `bytes` zeroes
+    uint32_t block(uint32_t a, uint32_t b, size_t bytes) {
+        align();
+        uint32_t at = pos();
+        out_.append(8 + bytes, '\0');
+        put(at, a, 4);
+        put(at + 4, b, 4);
+        return at;
+    }
+
+    // A string slot; the bytes themselves need no alignment
+    uint64_t text(std::string_view s) {
+        if (s.empty()) return 0;
+        uint32_t at = pos();
+        out_.append(s);
+        out_.push_back('\0');
+        return at | uint64_t(s.size()) << 32;
+    }
+
+    void set(uint32_t f, uint64_t v) { put(slots_ + 8 * f, v, 8); }
+
+    void put(uint32_t at, uint64_t v, size_t bytes) {
+        char* p = out_.data() + base_ + at;
+        for (size_t i = 0; i < bytes; ++i) p[i] = static_cast<char>(v >> (8 * i));
+    }
+
+    uint32_t pos() const { return static_cast<uint32_t>(out_.size() - base_); }
+    void align() { out_.resize(base_ + ((pos() + 7) & ~7u)); }
+
+    std::string& out_;
+    size_t base_;         // Where this snapshot starts in out_
+    uint32_t slots_ = 0;  // Of the record being filled
+};
+
+// -------------------- LOADER --------------------
+
+class Loader {
+public:
+    explicit Loader(Record rec) : rec_(rec) {}
+
+    template <class T>
+    void operator()(uint32_t f, T& v) {
+        if (!rec_.has(f)) return;
+        if constexpr (wire::isString<T> || std::is_same_v<T, Atom>)
+            v = rec_.str(f);
+        else if constexpr (std::is_same_v<T, bool>)
+            v = rec_.flag(f);
+        else if constexpr (std::is_floating_point_v<T>)
+            v = static_cast<T>(rec_.f64(f));
+        else
+            v = static_cast<T>(rec_.u64(f));
+    }
+
+    template <class T>
+    void record(uint32_t f, T& v) {
+        Loader sub(rec_.record(f));
+        visit(sub, v);
+    }
+
+    template <class T, class A>
+    void list(uint32_t f, std::vector<T, A>& v) {
+        List l = rec_.list(f);
+        v.clear();
+        v.reserve(l.size());
+        for (size_t i = 0; i < l.size(); ++i) {
+            if constexpr (wire::isString<T>) {
+                v.emplace_back(l.str(i));
+            } else if constexpr (std::is_arithmetic_v<T>) {
+                v.push_back(l.value<T>(i));
+            } else {
+                Loader sub(l.record(i));
+                visit(sub, v.emplace_back());
+            }
+        }
+    }
+
+private:
+    Record rec_;
+};
+
+} // namespace
+
+// -------------------- SNAPSHOT --------------------
+
+template <class Alloc>
+void write(const BasicInfo<Alloc>& info, std::string& out) {
+    Writer(out).root(info);
+}
+
+template <class Alloc>
+bool read(std::string_view blob, BasicInfo<Alloc>& info) {
+    View view(blob);
+    if (!view.ok()) return false;
+    BasicInfo<Alloc> out;
+    Loader loader(view.root());
+    visit(loader, out);
+    info = std::move(out);
+    return true;
+}
+
+template void write(const Info&, std::string&);
+template void write(const ArenaInfo&, std::string&);
+template bool read(std::string_view, Info&);
+template bool read(std::string_view, ArenaInfo&);
+
+} // namespace SystemInfo::snapshot
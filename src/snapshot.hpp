@@ -0,0 +1,229 @@
+#pragma once
+#include "sysinfo.hpp"
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace SystemInfo::snapshot {
+
+// A whole Info as one little-endian blob for shipping off the host. A
+// reader can mmap it and go straight to any field through View, without
+// parsing or allocating; read() turns it back into an Info.
+//
+// Offsets count from the start of the blob and every block starts 8-byte
+// aligned:
+//
+//   header  "NACS", u16 version, u16 header size, u32 blob size,
+//           u32 offset of the Info record
+//   record  u32 slot count, u32 0, then one 8-byte slot per field
+//   list    u32 count, u32 stride, then count elements of stride bytes
+//
+// A slot holds an integer or a bool as u64, a floating-point value as
+// the bits of a double, a string as u32 offset + u32 length (the bytes
+// are followed by a NUL), and a record or a list as u32 offset + u32 0.
+// Lists of records hold the records' slots inline, stride / 8 of them;
+// lists of strings hold string slots; per-CPU arrays hold the raw values.
+//
+// Fields are numbered below. New fields only ever go at the end of their
+// record: a reader finds the ones it knows in a newer blob, ignores the
+// rest, and sees the defaults for those an older blob lacks. The version
+// changes only for layouts old readers cannot follow.
+
+constexpr uint32_t kMagic = 0x5343414e;  // "NACS"
+constexpr uint16_t kVersion = 1;
+constexpr uint32_t kHeaderSize = 16;
+
+namespace field {
+
+namespace info {
+enum : uint32_t {
+    username, hostname, os_name, os_version, os_codename, os_id, kernel, kernel_version,
+    architecture, model, manufacturer, bios_version, board_name, chassis_type,
+    shell, shell_version, terminal, terminal_version,
+    uptime_seconds, boot_time, current_time, locale, timezone,
+    cpu, gpus, memory, swap, displays, disks, network_interfaces, batteries, de, packages,
+    total_packages, package_managers, unavailable, parse_errors,
+    kCount
+};
+} // namespace info
+
+namespace cpu {
+enum : uint32_t {
+    model, vendor, core_count, thread_count, max_freq_ghz, current_freq_ghz, architecture, per_cpu,
+    kCount
+};
+} // namespace cpu
+
+// Lists of f32, f32, f32, u8, i32, i32, i32
+namespace cpu_metrics {
+enum : uint32_t { freq_ghz, temp_c, utilization, online, package, core, node, kCount };
+} // namespace cpu_metrics
+
+namespace gpu {
+enum : uint32_t { model, vendor, driver, freq_ghz, memory_mb, is_integrated, temperature, kCount };
+} // namespace gpu
+
+namespace memory {
+enum : uint32_t {
+    total_bytes, used_bytes, available_bytes, free_bytes, cached_bytes, buffers_bytes, usage_percent,
+    kCount
+};
+} // namespace memory
+
+namespace swap {
+enum : uint32_t { total_bytes, used_bytes, free_bytes, usage_percent, kCount };
+} // namespace swap
+
+namespace display {
+enum : uint32_t {
+    name, width, height, refresh_rate, size_inches, is_builtin, output_name, current_mode,
+    kCount
+};
+} // namespace display
+
+namespace disk {
+enum : uint32_t {
+    mount_point, filesystem, total_bytes, used_bytes, available_bytes, free_bytes, usage_percent,
+    kCount
+};
+} // namespace disk
+
+namespace network_interface {
+enum : uint32_t {
+    name, ipv4, ipv6, mac, subnet_mask, is_up, is_wireless, operstate, ipv4_addresses, ifindex, mtu,
+    rx_bytes, tx_bytes, rx_packets, tx_packets, rx_errors, tx_errors, rx_dropped, tx_dropped,
+    kCount
+};
+} // namespace network_interface
+
+namespace battery {
+enum : uint32_t {
+    name, percentage, status, is_charging, ac_connected, time_remaining_mins, voltage, capacity_mah,
+    kCount
+};
+} // namespace battery
+
+namespace desktop_environment {
+enum : uint32_t {
+    name, version, wm_name, wm_protocol, theme, wm_theme, icon_theme, cursor_theme, cursor_size,
+    font_name, font_size,
+    kCount
+};
+} // namespace desktop_environment
+
+namespace package_info {
+enum : uint32_t { manager_name, count, kCount };
+} // namespace package_info
+
+} // namespace field
+
+// Appends the snapshot of `info` to `out`
+template <class Alloc>
+void write(const BasicInfo<Alloc>& info, std::string& out);
+
+// Replaces `info` with the snapshot at the start of `blob`. Returns false,
+// leaving it alone, if the blob is not a snapshot of this version or is
+// shorter than its header says.
+template <class Alloc>
+bool read(std::string_view blob, BasicInfo<Alloc>& info);
+
+namespace detail {
+template <class T>
+T load(const char* p) {
+    using U = std::conditional_t<sizeof(T) == 8, uint64_t,
+              std::conditional_t<sizeof(T) == 4, uint32_t, std::conditional_t<sizeof(T) == 2, uint16_t, uint8_t>>>;
+    U v = 0;
+    for (size_t i = 0; i < sizeof(T); ++i)
+        v |= static_cast<U>(static_cast<unsigned char>(p[i])) << (8 * i);
+    T out;
+    std::memcpy(&out, &v, sizeof(out));
+    return out;
+}
+} // namespace detail
+
+class List;
+
+// One record of a snapshot, pointing into the blob; cheap to copy. Fields
+// the record lacks, and offsets that point outside the blob, read as
+// zero, empty or absent.
+class Record {
+public:
+    Record() = default;
+
+    uint32_t fields() const { return fields_; }
+    bool has(uint32_t f) const { return f < fields_; }
+
+    uint64_t u64(uint32_t f) const { return has(f) ? detail::load<uint64_t>(slot(f)) : 0; }
+    int64_t i64(uint32_t f) const { return static_cast<int64_t>(u64(f)); }
+    double f64(uint32_t f) const { return has(f) ? detail::load<double>(slot(f)) : 0.0; }
+    bool flag(uint32_t f) const { return u64(f) != 0; }
+    std::string_view str(uint32_t f) const;
+    Record record(uint32_t f) const;
+    List list(uint32_t f) const;
+
+private:
+    friend class List;
+    friend class View;
+    Record(std::string_view blob, uint32_t slots, uint32_t fields) : blob_(blob), slots_(slots), fields_(fields) {}
+    static Record at(std::string_view blob, uint64_t offset);  // Of the record block there
+
+    const char* slot(uint32_t f) const { return blob_.data() + slots_ + 8 * f; }
+
+    std::string_view blob_;
+    uint32_t slots_ = 0;  // Offset of slot 0
+    uint32_t fields_ = 0;
+};
+
+// A list of records, strings or per-CPU values
+class List {
+public:
+    List() = default;
+
+    size_t size() const { return count_; }
+    uint32_t stride() const { return stride_; }
+
+    Record record(size_t i) const { return i < count_ ? Record(blob_, element(i), stride_ / 8) : Record(); }
+    std::string_view str(size_t i) const { return record(i).str(0); }
+
+    // Arrays of plain values: f32, i32 or u8. A stride that does not fit
+    // T reads as 0.
+    template <class T>
+    T value(size_t i) const {
+        if (i >= count_ || stride_ != sizeof(T)) return T{};
+        return detail::load<T>(blob_.data() + element(i));
+    }
+
+private:
+    friend class Record;
+    List(std::string_view blob, uint32_t data, uint32_t count, uint32_t stride)
+        : blob_(blob), data_(data), count_(count), stride_(stride) {}
+
+    uint32_t element(size_t i) const { return data_ + static_cast<uint32_t>(i) * stride_; }
+
+    std::string_view blob_;
+    uint32_t data_ = 0;  // Offset of element 0
+    uint32_t count_ = 0;
+    uint32_t stride_ = 0;
+};
+
+// The snapshot at the start of `blob`, e.g. an mmap'd file. Several can
+// follow one another; each is size() bytes long.
+class View {
+public:
+    explicit View(std::string_view blob);
+
+    bool ok() const { return ok_; }  // Magic, version and size check out
+    uint16_t version() const { return version_; }
+    size_t size() const { return blob_.size(); }
+    Record root() const { return root_; }
+
+private:
+    std::string_view blob_;
+    Record root_;
+    uint16_t version_ = 0;
+    bool ok_ = false;
+};
+
+} // namespace SystemInfo::snapshot
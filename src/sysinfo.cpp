@@ -1,18 +1,104 @@
 #include "sysinfo.hpp"
+#include "thread_pool.hpp"
+#include "cache.hpp"
+#include "io_batch.hpp"
+#include "netlink.hpp"
+#include "arena.hpp"
 
-#include <fstream>
-#include <sstream>
 #include <algorithm>
 #include <filesystem>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <future>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <charconv>
+#include <cmath>
+#include <limits>
+#include <cstring>
+#include <ctime>
+#include <fcntl.h>
 #include <unistd.h>
 #include <sys/utsname.h>
 #include <sys/sysinfo.h>
 #include <sys/statvfs.h>
+#include <sys/syscall.h>
+#include <sys/socket.h>
+#include <net/if.h>
+#include <net/if_arp.h>
+#include <linux/rtnetlink.h>
 #include <pwd.h>
 
 namespace fs = std::filesystem;
 namespace SystemInfo {
 
+// -------------------- I/O accounting --------------------
+
+// Every file the backend touches goes through these, so Flags::io_stats
+// can charge it to the collector running on the calling thread
+namespace io {
+
+thread_local IOStats* current = nullptr;  // Set by Fetcher::collect
+
+static int openat(int dirfd, const char* path, int flags) {
+    if (current) current->opens++;
+    return ::openat(dirfd, path, flags);
+}
+
+static ssize_t read(int fd, void* buf, size_t size) {
+    ssize_t n = ::read(fd, buf, size);
+    if (current) {
+        current->reads++;
+        if (n > 0) current->bytes += n;
+    }
+    return n;
+}
+
+static ssize_t pread(int fd, void* buf, size_t size, off_t offset) {
+    ssize_t n = ::pread(fd, buf, size, offset);
+    if (current) {
+        current->reads++;
+        if (n > 0) current->bytes += n;
+    }
+    return n;
+}
+
+static int faccessat(int dirfd, const char* path, int mode) {
+    if (current) current->stats++;
+    return ::faccessat(dirfd, path, mode, 0);
+}
+
+static int statvfs(const char* path, struct statvfs* st) {
+    if (current) current->stats++;
+    return ::statvfs(path, st);
+}
+
+static void readBatch(std::span<ReadRequest> requests) {
+    if (current) {
+        for (const ReadRequest& r : requests) {
+            if (r.fd < 0) current->opens++;
+        }
+    }
+    SystemInfo::readBatch(requests);
+    if (current) {
+        for (const ReadRequest& r : requests) {
+            if (r.fd >= 0 || r.result >= 0) current->reads++;
+            if (r.result > 0) current->bytes += r.result;
+        }
+    }
+}
+
+static void dirent() {
+    if (current) current->dirents++;
+}
+
+} // namespace io
+
 // -------------------- helpers --------------------
 
 static std::string trim(std::string s) {
@@ -21,44 +107,987 @@ static std::string trim(std::string s) {
     return s;
 }
 
-static std::string readFirstLine(const fs::path& p) {
-    std::ifstream f(p);
-    std::string s;
-    std::getline(f, s);
-    return trim(s);
+static std::string_view trimView(std::string_view s) {
+    size_t first = s.find_first_not_of(" \n\r\t");
+    if (first == std::string_view::npos) return {};
+    return s.substr(first, s.find_last_not_of(" \n\r\t") - first + 1);
+}
+
+// First line of `text`, trimmed and NUL-terminated in place so the result
+// can also be passed where a C string is expected
+static std::string_view firstLine(char* text, size_t len) {
+    std::string_view line = trimView(std::string_view(text, len).substr(0, strcspn(text, "\n")));
+    if (line.empty()) return {};
+    const_cast<char*>(line.data())[line.size()] = '\0';
+    return line;
+}
+
+// Small-file readers for procfs and sysfs: no iostream, no path objects,
+// no heap. The caller provides the buffer and the result points into it.
+
+// Whole file, up to size - 1 bytes, NUL-terminated. Empty if unreadable.
+// `name` is relative to dirfd, or absolute with AT_FDCWD.
+static std::string_view readSmallFile(int dirfd, const char* name, char* buf, size_t size) {
+    int fd = io::openat(dirfd, name, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return {};
+    size_t len = 0;
+    ssize_t n;
+    while (len < size - 1 && (n = io::read(fd, buf + len, size - 1 - len)) > 0)
+        len += n;
+    close(fd);
+    buf[len] = '\0';
+    return {buf, len};
+}
+
+// First line of a single-value attribute, trimmed. sysfs hands over a
+// whole attribute in one read, so this is one open, read and close.
+// `name` is relative to dirfd, or absolute with AT_FDCWD.
+static std::string_view readAttr(int dirfd, const char* name, char* buf, size_t size) {
+    int fd = io::openat(dirfd, name, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return {};
+    ssize_t n = io::read(fd, buf, size - 1);
+    close(fd);
+    if (n <= 0) return {};
+    buf[n] = '\0';
+    return firstLine(buf, n);
+}
+
+static std::string_view readAttr(const char* path, char* buf, size_t size) {
+    return readAttr(AT_FDCWD, path, buf, size);
+}
+
+// An open sysfs directory. Attributes are read with openat relative to it,
+// so a missing one shows up as a failed open instead of needing a stat
+// first, and no path strings are built along the way.
+class Dir {
+public:
+    explicit Dir(const char* path) : fd_(io::openat(AT_FDCWD, path, O_RDONLY | O_DIRECTORY | O_CLOEXEC)) {}
+    Dir(const Dir& parent, const char* name)
+        : fd_(parent ? io::openat(parent.fd_, name, O_RDONLY | O_DIRECTORY | O_CLOEXEC) : -1) {}
+    ~Dir() { if (fd_ >= 0) close(fd_); }
+
+    Dir(const Dir&) = delete;
+    Dir& operator=(const Dir&) = delete;
+
+    explicit operator bool() const { return fd_ >= 0; }
+    int fd() const { return fd_; }
+
+    std::string_view attr(const char* name, char* buf, size_t size) const {
+        return fd_ >= 0 ? readAttr(fd_, name, buf, size) : std::string_view();
+    }
+
+    std::string_view file(const char* name, char* buf, size_t size) const {
+        return fd_ >= 0 ? readSmallFile(fd_, name, buf, size) : std::string_view();
+    }
+
+    // For entries that are only ever tested for, like a NIC's "wireless"
+    bool has(const char* name) const {
+        return fd_ >= 0 && io::faccessat(fd_, name, F_OK) == 0;
+    }
+
+    // Calls fn(name) for every entry except . and .., straight from
+    // getdents64 without a DIR stream. Walks the directory once.
+    template <class F>
+    void forEach(F&& fn) const {
+        if (fd_ < 0) return;
+        struct linux_dirent64 {
+            uint64_t d_ino;
+            int64_t d_off;
+            unsigned short d_reclen;
+            unsigned char d_type;
+            char d_name[];
+        };
+        alignas(linux_dirent64) char buf[8192];
+        long n;
+        while ((n = syscall(SYS_getdents64, fd_, buf, sizeof(buf))) > 0) {
+            for (long pos = 0; pos < n;) {
+                auto* d = reinterpret_cast<linux_dirent64*>(buf + pos);
+                pos += d->d_reclen;
+                io::dirent();
+                if (strcmp(d->d_name, ".") != 0 && strcmp(d->d_name, "..") != 0)
+                    fn(static_cast<const char*>(d->d_name));
+            }
+        }
+    }
+
+private:
+    int fd_;
+};
+
+// Single-value attributes read together with readBatch: queue them with
+// add(), run(), then get() each one by the index add() returned
+class AttrBatch {
+public:
+    static constexpr size_t kSlot = 256;
+
+    // `path` is relative to dirfd, or absolute with AT_FDCWD
+    size_t add(int dirfd, std::string path) {
+        paths_.push_back(std::move(path));
+        requests_.push_back({.dirfd = dirfd, .size = kSlot});
+        return requests_.size() - 1;
+    }
+
+    // Points every request at its path and its slot of the buffer, which
+    // add() may have moved around
+    std::span<ReadRequest> requests() {
+        buf_.resize(requests_.size() * kSlot);
+        for (size_t i = 0; i < requests_.size(); i++) {
+            requests_[i].path = paths_[i].c_str();
+            requests_[i].buf = buf_.data() + i * kSlot;
+        }
+        return requests_;
+    }
+
+    void run() { io::readBatch(requests()); }
+
+    // First line, trimmed, as readAttr would return it
+    std::string_view get(size_t i) {
+        ReadRequest& r = requests_[i];
+        if (r.result <= 0) return {};
+        return firstLine(r.buf, r.result);
+    }
+
+    size_t size() const { return requests_.size(); }
+
+private:
+    std::vector<std::string> paths_;
+    std::vector<ReadRequest> requests_;
+    std::vector<char> buf_;
+};
+
+// Calls fn for every line of a NUL-terminated buffer
+template <class F>
+static void forEachLine(std::string_view text, F&& fn) {
+    while (!text.empty()) {
+        size_t end = text.find('\n');
+        fn(text.substr(0, end));
+        if (end == std::string_view::npos) break;
+        text.remove_prefix(end + 1);
+    }
+}
+
+// Calls fn(key, value) for every KEY=VALUE line of a sysfs uevent file,
+// which carries most of a device's attributes in one read
+template <class F>
+static void forEachUevent(std::string_view text, F&& fn) {
+    forEachLine(text, [&fn](std::string_view line) {
+        size_t eq = line.find('=');
+        if (eq != std::string_view::npos)
+            fn(line.substr(0, eq), line.substr(eq + 1));
+    });
+}
+
+// All of `text` but surrounding whitespace as a T, through from_chars:
+// no locale, no exceptions, no allocation. Empty for no digits, trailing
+// junk, or a value out of T's range.
+template <class T>
+static std::optional<T> parseNumber(std::string_view text) {
+    text = trimView(text);
+    T value{};
+    const char* end = text.data() + text.size();
+    auto [ptr, ec] = std::from_chars(text.data(), end, value);
+    if (ec != std::errc() || ptr != end) return std::nullopt;
+    return value;
+}
+
+// sysfs cpulists never name more CPUs than this; larger ids are garbage
+constexpr unsigned kMaxCPUs = 1u << 16;
+
+// Calls fn(id) for every CPU of a sysfs cpulist like "0-3,8-11". Returns
+// false, stopping there, at anything that is not one.
+template <class F>
+static bool forEachInCPUList(std::string_view list, F&& fn) {
+    list = trimView(list);
+    while (!list.empty()) {
+        size_t comma = list.find(',');
+        std::string_view range = list.substr(0, comma);
+        list.remove_prefix(comma == std::string_view::npos ? list.size() : comma + 1);
+        size_t dash = range.find('-');
+        auto first = parseNumber<unsigned>(range.substr(0, dash));
+        auto last = dash == std::string_view::npos ? first : parseNumber<unsigned>(range.substr(dash + 1));
+        if (!first || !last || *last < *first || *last >= kMaxCPUs) return false;
+        for (unsigned id = *first; id <= *last; id++) fn(id);
+    }
+    return true;
+}
+
+// getline over a raw fd for procfs files too long to read whole, or read
+// only in part: /proc/cpuinfo, /proc/mounts
+class LineReader {
+public:
+    explicit LineReader(const char* path) : fd_(io::openat(AT_FDCWD, path, O_RDONLY | O_CLOEXEC)) {}
+    ~LineReader() { if (fd_ >= 0) close(fd_); }
+
+    LineReader(const LineReader&) = delete;
+    LineReader& operator=(const LineReader&) = delete;
+
+    // Next line without its newline; false at the end of the file
+    bool getline(std::string& line) {
+        line.clear();
+        for (;;) {
+            if (const void* nl = memchr(buf_ + pos_, '\n', len_ - pos_)) {
+                size_t end = static_cast<const char*>(nl) - buf_;
+                line.append(buf_ + pos_, end - pos_);
+                pos_ = end + 1;
+                return true;
+            }
+            line.append(buf_ + pos_, len_ - pos_);
+            pos_ = len_ = 0;
+            ssize_t n = fd_ >= 0 ? io::read(fd_, buf_, sizeof(buf_)) : 0;
+            if (n <= 0) {
+                if (fd_ >= 0) close(fd_);
+                fd_ = -1;
+                return !line.empty();
+            }
+            len_ = n;
+        }
+    }
+
+private:
+    int fd_;
+    char buf_[4096];
+    size_t pos_ = 0;
+    size_t len_ = 0;
+};
+
+// -------------------- FILE CACHE --------------------
+
+// Files sampled on every fetch and refresh stay open: re-reading one is a
+// single pread at offset 0, which makes procfs and sysfs regenerate it.
+// Shared with deadline shadows, so lookups are locked; reads are not.
+template <class Alloc>
+struct BasicFetcher<Alloc>::FileCache {
+    std::mutex mutex;
+    std::unordered_map<std::string, int> fds;
+
+    FileCache() = default;
+    FileCache(const FileCache&) = delete;
+    FileCache& operator=(const FileCache&) = delete;
+
+    ~FileCache() {
+        for (const auto& [path, fd] : fds)
+            close(fd);
+    }
+
+    // Reads up to size - 1 bytes and NUL-terminates them. Returns the
+    // length, or -1 on failure, which also forgets the handle so a device
+    // that went away and came back is reopened next time.
+    ssize_t read(const std::string& path, char* buf, size_t size) {
+        int fd = get(path);
+        if (fd < 0) return -1;
+        ssize_t n = io::pread(fd, buf, size - 1, 0);
+        if (n < 0) {
+            drop(path, fd);
+            return -1;
+        }
+        buf[n] = '\0';
+        return n;
+    }
+
+    // The open handle for `path`, or -1
+    int find(const std::string& path) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = fds.find(path);
+        return it != fds.end() ? it->second : -1;
+    }
+
+    // Takes ownership of fd. Returns the handle now cached for `path`,
+    // which is someone else's if they got there first.
+    int adopt(const std::string& path, int fd) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto [it, inserted] = fds.emplace(path, fd);
+        if (!inserted && it->second != fd)
+            close(fd);
+        return it->second;
+    }
+
+    void drop(const std::string& path, int fd) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (auto it = fds.find(path); it != fds.end() && it->second == fd) {
+            close(fd);
+            fds.erase(it);
+        }
+    }
+
+private:
+    int get(const std::string& path) {
+        if (int fd = find(path); fd >= 0)
+            return fd;
+        // Open unlocked: collectors own disjoint files, so a race here
+        // only happens between a collector and its abandoned predecessor
+        int fd = io::openat(AT_FDCWD, path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) return -1;
+        return adopt(path, fd);
+    }
+};
+
+// readAttr for a file kept open in files_
+template <class Alloc>
+std::string_view BasicFetcher<Alloc>::readCachedAttr(const std::string& path, char* buf, size_t size) {
+    ssize_t n = files_->read(path, buf, size);
+    if (n <= 0) return {};
+    return firstLine(buf, n);
+}
+
+// parseNumber for collector input. `field` names the value where the
+// kernel does: a procfs key or a sysfs attribute. Missing text is not an
+// error, only text that is not a number.
+template <class Alloc>
+template <class T>
+std::optional<T> BasicFetcher<Alloc>::parse(std::string_view field, std::string_view text) {
+    std::optional<T> value = parseNumber<T>(text);
+    if (!value && !trimView(text).empty())
+        parseError(field, text);
+    return value;
 }
 
+// Collectors run concurrently, so unlike their own sections of info_ this
+// list is shared
+template <class Alloc>
+void BasicFetcher<Alloc>::parseError(std::string_view field, std::string_view text) {
+    std::string entry(field);
+    entry += ": \"";
+    entry += trimView(text).substr(0, 32);
+    entry += '"';
+    std::lock_guard<std::mutex> lock(errors_mutex_);
+    info_.parse_errors.emplace_back(entry);
+}
+
+// readBatch for files kept open in files_: cached ones are only re-read,
+// the rest are opened by the batch and stay open. Paths must be absolute.
+template <class Alloc>
+void BasicFetcher<Alloc>::readCachedBatch(std::span<ReadRequest> requests) {
+    for (ReadRequest& r : requests) {
+        r.fd = files_->find(r.path);
+        r.keep = true;
+    }
+    io::readBatch(requests);
+    for (ReadRequest& r : requests) {
+        if (r.fd < 0) continue;
+        files_->adopt(r.path, r.fd);
+        if (r.result < 0)
+            files_->drop(r.path, r.fd);
+    }
+}
+
+// -------------------- Info --------------------
+
+template <class Alloc>
+BasicInfo<Alloc>::BasicInfo(const allocator_type& a)
+    : username(a), hostname(a), os_name(a), os_version(a), os_codename(a), os_id(a), kernel(a),
+      kernel_version(a), architecture(a), model(a), manufacturer(a), bios_version(a),
+      board_name(a), chassis_type(a), shell(a), shell_version(a), terminal(a), terminal_version(a),
+      boot_time(a), current_time(a), locale(a), timezone(a), cpu(a), gpus(a), displays(a),
+      disks(a), network_interfaces(a), batteries(a), de(a), packages(a), package_managers(a),
+      unavailable(a), parse_errors(a) {}
+
 // -------------------- Fetcher --------------------
 
-Fetcher::Fetcher() = default;
+// Every collector writes a disjoint set of fields in info_, so collectors
+// only need ordering where one reads what another wrote.
+template <class Alloc>
+struct BasicFetcher<Alloc>::Collector {
+    const char* name;
+    bool Flags::* flag;         // nullptr: always runs
+    void (BasicFetcher::*fetch)();
+    uint32_t deps;              // Bitmask of collectors that must finish first
+
+    static const Collector table[];
+};
 
-void Fetcher::fetchInfo(const Flags& flags) {
-    fetchBasicInfo();
+namespace {
+enum CollectorIndex : uint32_t {
+    kBasic, kOS, kKernel, kHost, kCPU, kCPUFreq, kGPU, kMemory, kDisk,
+    kDisplay, kNetwork, kBattery, kUptime, kShell, kTerminal, kDE, kLocale,
+    kBatteryLevel, kDiskUsage, kNetworkStats,
+    kCollectorCount
+};
+static_assert(kCollectorCount <= 32, "dependency masks are 32 bits wide");
 
-    if (flags.os)        fetchOSInfo();
-    if (flags.kernel)    fetchKernelInfo();
-    if (flags.model)     fetchHostInfo();
-    if (flags.cpu)       fetchCPUInfo();
-    if (flags.gpu)       fetchGPUInfo();
-    if (flags.memory)    fetchMemoryInfo();
-    if (flags.swap)      fetchSwapInfo();
-    if (flags.disk)      fetchDiskInfo();
-    if (flags.display)   fetchDisplayInfo();
-    if (flags.network)   fetchNetworkInfo();
-    if (flags.battery)   fetchBatteryInfo();
-    if (flags.uptime)    fetchUptimeInfo();
-    if (flags.shell)     fetchShellInfo();
-    if (flags.terminal)  fetchTerminalInfo();
-    if (flags.de)        fetchDesktopEnvironment();
+// Collectors whose results only change across reboots, see cache.hpp
+constexpr uint32_t kStaticCollectors =
+    (1u << kOS) | (1u << kKernel) | (1u << kHost) | (1u << kCPU) | (1u << kGPU);
 
-    fetchLocaleInfo();
+// Collectors that update what an earlier fetch found instead of looking
+// for it, so only refresh() runs them
+constexpr uint32_t kUpdateCollectors = (1u << kBatteryLevel) | (1u << kDiskUsage) | (1u << kNetworkStats);
+
+// Everything refresh() re-reads
+constexpr uint32_t kVolatileCollectors =
+    (1u << kCPUFreq) | (1u << kMemory) | (1u << kUptime) | kUpdateCollectors;
+
+// Promises behind an AsyncInfo, fulfilled as their collectors finish
+template <class Alloc>
+struct AsyncPromises {
+    using Info = BasicInfo<Alloc>;
+    template <class T>
+    using List = typename Info::template List<T>;
+
+    std::promise<typename Info::CPU> cpu;
+    std::promise<List<typename Info::GPU>> gpus;
+    std::promise<Memory> memory;
+    std::promise<Swap> swap;
+    std::promise<List<typename Info::Disk>> disks;
+    std::promise<List<typename Info::Display>> displays;
+    std::promise<List<typename Info::NetworkInterface>> network_interfaces;
+    std::promise<List<typename Info::Battery>> batteries;
+    std::promise<typename Info::DesktopEnvironment> de;
+    std::promise<uint64_t> uptime_seconds;
+    std::promise<void> all;
+
+    BasicAsyncInfo<Alloc> handles() {
+        return {cpu.get_future(), gpus.get_future(), memory.get_future(),
+                swap.get_future(), disks.get_future(), displays.get_future(),
+                network_interfaces.get_future(), batteries.get_future(),
+                de.get_future(), uptime_seconds.get_future(), all.get_future()};
+    }
+
+    // Copies out the section a collector owns; info keeps its own copy
+    void publish(const Info& info, size_t index) {
+        switch (index) {
+        case kCPUFreq: cpu.set_value(info.cpu); break;  // Last writer of the section
+        case kGPU:     gpus.set_value(info.gpus); break;
+        case kMemory:
+            memory.set_value(info.memory);
+            swap.set_value(info.swap);
+            break;
+        case kDisk:    disks.set_value(info.disks); break;
+        case kDisplay: displays.set_value(info.displays); break;
+        case kNetwork: network_interfaces.set_value(info.network_interfaces); break;
+        case kBattery: batteries.set_value(info.batteries); break;
+        case kDE:      de.set_value(info.de); break;
+        case kUptime:  uptime_seconds.set_value(info.uptime_seconds); break;
+        default: break;
+        }
+    }
+};
+
+// Copies the fields a collector owns. Used instead of a move because a
+// dependent may still be reading them.
+template <class Alloc>
+void copySection(BasicInfo<Alloc>& dst, const BasicInfo<Alloc>& src, size_t index) {
+    switch (index) {
+    case kBasic:
+        dst.username = src.username;
+        dst.hostname = src.hostname;
+        dst.architecture = src.architecture;
+        break;
+    case kOS:
+        dst.os_name = src.os_name;
+        dst.os_version = src.os_version;
+        dst.os_codename = src.os_codename;
+        break;
+    case kKernel:
+        dst.kernel = src.kernel;
+        dst.kernel_version = src.kernel_version;
+        break;
+    case kHost:
+        dst.model = src.model;
+        dst.manufacturer = src.manufacturer;
+        dst.bios_version = src.bios_version;
+        dst.board_name = src.board_name;
+        break;
+    case kCPU:
+        // The topology only: cpufreq may still be sampling the rest
+        dst.cpu.per_cpu.package = src.cpu.per_cpu.package;
+        dst.cpu.per_cpu.core = src.cpu.per_cpu.core;
+        dst.cpu.per_cpu.node = src.cpu.per_cpu.node;
+        dst.cpu.model = src.cpu.model;
+        dst.cpu.vendor = src.cpu.vendor;
+        dst.cpu.core_count = src.cpu.core_count;
+        dst.cpu.thread_count = src.cpu.thread_count;
+        dst.cpu.max_freq_ghz = src.cpu.max_freq_ghz;
+        dst.cpu.current_freq_ghz = src.cpu.current_freq_ghz;
+        break;
+    case kCPUFreq:
+        dst.cpu.current_freq_ghz = src.cpu.current_freq_ghz;
+        dst.cpu.architecture = src.cpu.architecture;
+        dst.cpu.per_cpu.freq_ghz = src.cpu.per_cpu.freq_ghz;
+        dst.cpu.per_cpu.temp_c = src.cpu.per_cpu.temp_c;
+        dst.cpu.per_cpu.utilization = src.cpu.per_cpu.utilization;
+        dst.cpu.per_cpu.online = src.cpu.per_cpu.online;
+        break;
+    case kGPU:      dst.gpus = src.gpus; break;
+    case kMemory:
+        dst.memory = src.memory;
+        dst.swap = src.swap;
+        break;
+    case kDisk:     dst.disks = src.disks; break;
+    case kDisplay:  dst.displays = src.displays; break;
+    case kNetwork:  dst.network_interfaces = src.network_interfaces; break;
+    case kBattery:  dst.batteries = src.batteries; break;
+    case kUptime:   dst.uptime_seconds = src.uptime_seconds; break;
+    case kShell:    dst.shell = src.shell; break;
+    case kTerminal: dst.terminal = src.terminal; break;
+    case kDE:       dst.de = src.de; break;
+    case kLocale:   dst.locale = src.locale; break;
+    case kBatteryLevel: dst.batteries = src.batteries; break;
+    case kDiskUsage:    dst.disks = src.disks; break;
+    case kNetworkStats: dst.network_interfaces = src.network_interfaces; break;
+    default: break;
+    }
+}
+}
+
+// One pass over the collector table on the thread pool
+template <class Alloc>
+struct BasicFetcher<Alloc>::Schedule {
+    uint32_t enabled = 0;
+    uint32_t ready = 0;     // Enabled with nothing to wait for, dispatched up front
+    bool timings = false;
+    bool io_stats = false;
+    std::array<std::atomic<uint32_t>, kCollectorCount> waiting;  // Unfinished dependencies
+    std::atomic<uint32_t> remaining{0};                          // Unfinished collectors
+    std::unique_ptr<AsyncPromises<Alloc>> promises;              // fetchAsync only
+
+    // Deadline fetches run on deadlinePool() against a private Fetcher,
+    // so a collector stuck in the kernel can be left behind without ever
+    // touching the caller's Info or blocking the pool's shutdown.
+    std::unique_ptr<BasicFetcher> shadow;
+    std::mutex mutex;
+    std::condition_variable progress;
+    uint32_t finished = 0;  // Guarded by mutex
+};
+
+// Listed in dependency order, which is also the sequential fetch order.
+// Update collectors go last.
+template <class Alloc>
+const typename BasicFetcher<Alloc>::Collector BasicFetcher<Alloc>::Collector::table[kCollectorCount] = {
+    {"basic",    nullptr,         &BasicFetcher::fetchBasicInfo,          0},
+    {"os",       &Flags::os,      &BasicFetcher::fetchOSInfo,             0},
+    {"kernel",   &Flags::kernel,  &BasicFetcher::fetchKernelInfo,         0},
+    {"host",     &Flags::model,   &BasicFetcher::fetchHostInfo,           0},
+    {"cpu",      &Flags::cpu,     &BasicFetcher::fetchCPUInfo,            0},
+    {"cpufreq",  &Flags::cpu,     &BasicFetcher::fetchCPUFrequencies,     (1u << kBasic) | (1u << kCPU)},  // Copies architecture, overrides the cpuinfo clock
+    {"gpu",      &Flags::gpu,     &BasicFetcher::fetchGPUInfo,            0},
+    {"memory",   &Flags::memory,  &BasicFetcher::fetchMemoryInfo,         0},  // Swap too, see enabledCollectors
+    {"disk",     &Flags::disk,    &BasicFetcher::fetchDiskInfo,           0},
+    {"display",  &Flags::display, &BasicFetcher::fetchDisplayInfo,        0},
+    {"network",  &Flags::network, &BasicFetcher::fetchNetworkInfo,        0},
+    {"battery",  &Flags::battery, &BasicFetcher::fetchBatteryInfo,        0},
+    {"uptime",   &Flags::uptime,  &BasicFetcher::fetchUptimeInfo,         0},
+    {"shell",    &Flags::shell,   &BasicFetcher::fetchShellInfo,          0},
+    {"terminal", &Flags::terminal,&BasicFetcher::fetchTerminalInfo,       0},
+    {"de",       &Flags::de,      &BasicFetcher::fetchDesktopEnvironment, 0},
+    {"locale",   nullptr,         &BasicFetcher::fetchLocaleInfo,         0},
+    {"battery-level", &Flags::battery, &BasicFetcher::refreshBatteryLevels, 0},
+    {"disk-usage",    &Flags::disk,    &BasicFetcher::refreshDiskUsage,     0},
+    {"network-stats", &Flags::network, &BasicFetcher::refreshNetworkStats,  0},
+};
+
+template <class Alloc>
+BasicFetcher<Alloc>::BasicFetcher()
+    : files_(std::make_shared<FileCache>()), stuck_mounts_(std::make_shared<StuckMounts>()) {}
+template <class Alloc>
+BasicFetcher<Alloc>::BasicFetcher(Info info)
+    : info_(std::move(info)), files_(std::make_shared<FileCache>()), stuck_mounts_(std::make_shared<StuckMounts>()) {}
+template <class Alloc>
+BasicFetcher<Alloc>::BasicFetcher(Arena& arena) requires std::is_same_v<Alloc, std::pmr::polymorphic_allocator<>>
+    : info_(typename Info::allocator_type(&arena)), files_(std::make_shared<FileCache>()),
+      stuck_mounts_(std::make_shared<StuckMounts>()), arena_(&arena),
+      reports_(std::make_unique<Arena>(1024)) {}
+
+// Work a fetchAsync left on the pool still writes to info_ and the other
+// members, so it has to finish before any of them goes
+template <class Alloc>
+BasicFetcher<Alloc>::~BasicFetcher() {
+    if (!pool_) return;
+    pool_->wait();
+    pool_.reset();
+}
+
+// Nothing the last fetch put in the arena outlives this: info_ is rebuilt
+// from scratch, and the shadows of deadline fetches use the heap
+template <class Alloc>
+void BasicFetcher<Alloc>::resetArena() {
+    if constexpr (std::is_same_v<Alloc, std::pmr::polymorphic_allocator<>>) {
+        if (!arena_) return;
+        std::destroy_at(&info_);
+        arena_->reset();
+        std::construct_at(&info_, typename Info::allocator_type(arena_));
+    }
+}
+
+// Cleared in place, the lists would leave their strings behind in an
+// arena on every fetch and refresh, so there they get reports_ afresh
+template <class Alloc>
+void BasicFetcher<Alloc>::clearReports() {
+    if constexpr (std::is_same_v<Alloc, std::pmr::polymorphic_allocator<>>) {
+        if (reports_) {
+            std::destroy_at(&info_.unavailable);
+            std::destroy_at(&info_.parse_errors);
+            reports_->reset();
+            std::construct_at(&info_.unavailable, typename Info::allocator_type(reports_.get()));
+            std::construct_at(&info_.parse_errors, typename Info::allocator_type(reports_.get()));
+            return;
+        }
+    }
+    info_.unavailable.clear();
+    info_.parse_errors.clear();
+}
+
+template <class Alloc>
+void BasicFetcher<Alloc>::fetchInfo(const Flags& flags) {
+    resetArena();
+    clearReports();
+    timings_.assign(flags.timings ? size_t(kCollectorCount) : 0, Timing{});
+    io_stats_.assign(flags.io_stats ? size_t(kCollectorCount) : 0, IOStats{});
+    const uint32_t wanted = enabledCollectors(flags) & ~kUpdateCollectors;
+    const uint32_t cached = restoreStaticCache(flags);
+    run(flags, wanted & ~cached);
+
+    // Only a complete set is worth caching: a later run may want all of it
+    if (flags.static_cache && !cached && (wanted & kStaticCollectors) == kStaticCollectors &&
+        info_.unavailable.empty())
+        writeStaticCache(staticCachePath(), info_);
+}
+
+template <class Alloc>
+void BasicFetcher<Alloc>::refresh(const Flags& flags) {
+    clearReports();
+    timings_.assign(flags.timings ? size_t(kCollectorCount) : 0, Timing{});
+    io_stats_.assign(flags.io_stats ? size_t(kCollectorCount) : 0, IOStats{});
+    run(flags, enabledCollectors(flags) & kVolatileCollectors);
+}
+
+template <class Alloc>
+void BasicFetcher<Alloc>::run(const Flags& flags, uint32_t enabled) {
+    if (flags.deadline_us > 0) {
+        fetchWithDeadline(flags, enabled);
+    } else if (!flags.parallel) {
+        fetchSequential(flags, enabled);
+    } else {
+        // Hand all but the first ready collector to the pool; the calling
+        // thread takes the first one itself and then helps with the rest.
+        auto s = schedule(flags, enabled);
+        size_t first = kCollectorCount;
+        for (size_t i = 0; i < kCollectorCount; ++i) {
+            if (!(s->ready & (1u << i))) continue;
+            if (first == kCollectorCount)
+                first = i;
+            else
+                dispatch(s, i);
+        }
+        if (first != kCollectorCount)
+            pool().runAndWait([this, &s, first] { runCollector(s, first); });
+    }
 }
 
-const Info& Fetcher::getInfo() const { return info_; }
+template <class Alloc>
+typename BasicFetcher<Alloc>::AsyncInfo BasicFetcher<Alloc>::fetchAsync(const Flags& flags) {
+    resetArena();
+    clearReports();
+    timings_.assign(flags.timings ? size_t(kCollectorCount) : 0, Timing{});
+    io_stats_.assign(flags.io_stats ? size_t(kCollectorCount) : 0, IOStats{});
+    auto s = schedule(flags, enabledCollectors(flags) & ~kUpdateCollectors & ~restoreStaticCache(flags));
+    s->promises = std::make_unique<AsyncPromises<Alloc>>();
+    AsyncInfo handles = s->promises->handles();
+
+    // Sections that will not be fetched are ready straight away
+    for (size_t i = 0; i < kCollectorCount; ++i) {
+        if (!(s->enabled & (1u << i)))
+            s->promises->publish(info_, i);
+    }
+    for (size_t i = 0; i < kCollectorCount; ++i) {
+        if (s->ready & (1u << i))
+            dispatch(s, i);
+    }
+    return handles;
+}
+
+template <class Alloc>
+void BasicFetcher<Alloc>::fetchWithDeadline(const Flags& flags, uint32_t wanted) {
+    const auto deadline = std::chrono::steady_clock::now() +
+                          std::chrono::microseconds(flags.deadline_us);
+
+    // A collector an earlier fetch left running is not started again until
+    // it returns: a hung one ties up one worker, not one more per fetch.
+    // If it returns before this deadline, its result is taken instead.
+    uint32_t busy = 0;
+    std::vector<std::pair<std::shared_ptr<Schedule>, uint32_t>> owed;
+    std::erase_if(abandoned_, [&](const std::shared_ptr<Schedule>& old) {
+        std::lock_guard<std::mutex> lock(old->mutex);
+        const uint32_t running = old->enabled & ~old->finished;
+        if (running & wanted)
+            owed.emplace_back(old, running & wanted);
+        busy |= running;
+        return running == 0;
+    });
+    const uint32_t enabled = wanted & ~busy;
+
+    auto s = schedule(flags, enabled);
+    s->shadow = std::make_unique<BasicFetcher>();
+    s->shadow->timings_.resize(timings_.size());
+    s->shadow->io_stats_.resize(io_stats_.size());
+    s->shadow->files_ = files_;
+    s->shadow->stuck_mounts_ = stuck_mounts_;
+    if (enabled & (1u << kCPUFreq))
+        s->shadow->cpu_samples_ = std::move(cpu_samples_);
+
+    // The shadow starts empty: hand it what the collectors will read,
+    // the sections of disabled dependencies and those updated in place
+    uint32_t inputs = enabled & kUpdateCollectors;
+    for (size_t i = 0; i < kCollectorCount; ++i) {
+        if (enabled & (1u << i))
+            inputs |= Collector::table[i].deps & ~enabled;
+    }
+    for (size_t i = 0; i < kCollectorCount; ++i) {
+        if (inputs & (1u << i))
+            copySection(s->shadow->info_, info_, i);
+    }
+    for (size_t i = 0; i < kCollectorCount; ++i) {
+        if (s->ready & (1u << i))
+            s->shadow->dispatch(s, i);
+    }
+
+    // Takes the sections of the collectors in `done` from a schedule's shadow
+    auto take = [&](Schedule& from, uint32_t done) {
+        for (size_t i = 0; i < kCollectorCount; ++i) {
+            if (!(done & (1u << i))) continue;
+            copySection(info_, from.shadow->info_, i);
+            if (from.timings && s->timings)
+                timings_[i] = from.shadow->timings_[i];
+            if (from.io_stats && s->io_stats)
+                io_stats_[i] = from.shadow->io_stats_[i];
+            if (i == kCPUFreq)
+                cpu_samples_ = std::move(from.shadow->cpu_samples_);
+        }
+    };
+
+    // Every wait ends at the same deadline, so waiting in turn costs no more
+    uint32_t finished;
+    {
+        std::unique_lock<std::mutex> lock(s->mutex);
+        s->progress.wait_until(lock, deadline, [&] { return s->finished == s->enabled; });
+        finished = s->finished;
+    }
+    if (finished != s->enabled)
+        abandoned_.push_back(s);
+    take(*s, finished);
+    for (const auto& [old, running] : owed) {
+        uint32_t late;
+        {
+            std::unique_lock<std::mutex> lock(old->mutex);
+            old->progress.wait_until(lock, deadline, [&] { return (old->finished & running) == running; });
+            late = old->finished & running;
+        }
+        take(*old, late);
+        finished |= late;
+    }
+
+    for (size_t i = 0; i < kCollectorCount; ++i) {
+        if ((wanted & (1u << i)) && !(finished & (1u << i)))
+            info_.unavailable.push_back(Collector::table[i].name);
+    }
+    // Abandoned collectors may still be adding to the shadow's lists
+    std::lock_guard<std::mutex> lock(s->shadow->errors_mutex_);
+    const auto& errors = s->shadow->info_.parse_errors;
+    info_.parse_errors.insert(info_.parse_errors.end(), errors.begin(), errors.end());
+    const auto& mounts = s->shadow->info_.unavailable;
+    info_.unavailable.insert(info_.unavailable.end(), mounts.begin(), mounts.end());
+}
+
+template <class Alloc>
+void BasicFetcher<Alloc>::fetchSequential(const Flags& flags, uint32_t enabled) {
+    for (size_t i = 0; i < kCollectorCount; ++i) {
+        if (enabled & (1u << i))
+            collect(i, flags.timings, flags.io_stats);
+    }
+}
+
+template <class Alloc>
+uint32_t BasicFetcher<Alloc>::enabledCollectors(const Flags& flags) {
+    uint32_t enabled = 0;
+    for (size_t i = 0; i < kCollectorCount; ++i) {
+        const Collector& c = Collector::table[i];
+        if (!c.flag || flags.*c.flag)
+            enabled |= 1u << i;
+    }
+    // Memory and swap come from the same read of /proc/meminfo
+    if (flags.swap)
+        enabled |= 1u << kMemory;
+    return enabled;
+}
+
+// Fills the static sections the flags ask for from the on-disk cache and
+// returns the collectors that no longer need to run; none on a miss
+template <class Alloc>
+uint32_t BasicFetcher<Alloc>::restoreStaticCache(const Flags& flags) {
+    const uint32_t wanted = enabledCollectors(flags) & kStaticCollectors;
+    if (!flags.static_cache || !wanted) return 0;
+
+    Info cached;
+    if (!readStaticCache(staticCachePath(), cached)) return 0;
+    for (size_t i = 0; i < kCollectorCount; ++i) {
+        if (wanted & (1u << i))
+            copySection(info_, cached, i);
+    }
+    return wanted;
+}
+
+// Runs one collector, recording its cost in its own timings_ and
+// io_stats_ slots so concurrent collectors never share an element
+template <class Alloc>
+void BasicFetcher<Alloc>::collect(size_t index, bool timed, bool counted) {
+    const Collector& c = Collector::table[index];
+    if (counted) {
+        io_stats_[index].name = c.name;
+        io::current = &io_stats_[index];
+    }
+    Stopwatch watch;
+    if (timed) watch.start();
+    (this->*c.fetch)();
+    if (timed) timings_[index] = watch.stop(c.name);
+    io::current = nullptr;
+}
+
+template <class Alloc>
+auto BasicFetcher<Alloc>::schedule(const Flags& flags, uint32_t enabled) -> std::shared_ptr<Schedule> {
+    auto s = std::make_shared<Schedule>();
+    s->enabled = enabled;
+
+    // Disabled dependencies count as already satisfied
+    for (size_t i = 0; i < kCollectorCount; ++i)
+        s->waiting[i] = std::popcount(Collector::table[i].deps & s->enabled);
+
+    // Fixed before anything runs: once dispatching starts, a dependent can
+    // reach zero waiting and must then only be dispatched by its releaser
+    for (size_t i = 0; i < kCollectorCount; ++i) {
+        if ((s->enabled & (1u << i)) && s->waiting[i] == 0)
+            s->ready |= 1u << i;
+    }
+    s->remaining = std::popcount(s->enabled);
+    s->timings = flags.timings;
+    s->io_stats = flags.io_stats;
+    return s;
+}
+
+// Shared by the deadline fetches of every Fetcher and never torn down, so
+// a collector that does not return holds up neither a destructor nor the
+// exit. One worker per collector: each is dispatched at most once per
+// Fetcher until it returns, so a Fetcher's own hung collectors cannot
+// starve the rest of its fetch.
+static ThreadPool& deadlinePool() {
+    static ThreadPool* pool = new ThreadPool(kCollectorCount);
+    return *pool;
+}
+
+template <class Alloc>
+void BasicFetcher<Alloc>::dispatch(const std::shared_ptr<Schedule>& s, size_t index) {
+    if (s->shadow) {
+        deadlinePool().enqueue([this, s, index] { runCollector(s, index); });
+        return;
+    }
+    pool().enqueue([this, s, index] { runCollector(s, index); });
+}
+
+template <class Alloc>
+ThreadPool& BasicFetcher<Alloc>::pool() {
+    if (!pool_) {
+        size_t threads = std::clamp<size_t>(std::thread::hardware_concurrency(), 1, kCollectorCount);
+        pool_ = std::make_unique<ThreadPool>(threads);
+    }
+    return *pool_;
+}
+
+template <class Alloc>
+void BasicFetcher<Alloc>::runCollector(const std::shared_ptr<Schedule>& s, size_t index) {
+    collect(index, s->timings, s->io_stats);
+    if (s->promises)
+        s->promises->publish(info_, index);
+
+    // Release the dependents this collector was the last blocker of
+    for (size_t j = 0; j < kCollectorCount; ++j) {
+        if ((s->enabled & (1u << j)) && (Collector::table[j].deps & (1u << index)) &&
+            s->waiting[j].fetch_sub(1, std::memory_order_acq_rel) == 1)
+            dispatch(s, j);
+    }
+
+    if (s->shadow) {
+        {
+            std::lock_guard<std::mutex> lock(s->mutex);
+            s->finished |= 1u << index;
+        }
+        s->progress.notify_one();
+    }
+
+    if (s->remaining.fetch_sub(1, std::memory_order_acq_rel) == 1 && s->promises)
+        s->promises->all.set_value();
+}
+
+template <class Alloc>
+auto BasicFetcher<Alloc>::getInfo() const -> const Info& { return info_; }
+
+template <class Alloc>
+std::vector<Timing> BasicFetcher<Alloc>::getTimings() const {
+    std::vector<Timing> out;
+    for (const Timing& t : timings_) {
+        if (!t.name.empty())
+            out.push_back(t);
+    }
+    return out;
+}
+
+template <class Alloc>
+std::vector<IOStats> BasicFetcher<Alloc>::getIOStats() const {
+    std::vector<IOStats> out;
+    for (const IOStats& s : io_stats_) {
+        if (!s.name.empty())
+            out.push_back(s);
+    }
+    return out;
+}
+
+// -------------------- TIMINGS --------------------
+
+static uint64_t clockNs(clockid_t clock) {
+    timespec ts;
+    clock_gettime(clock, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ull + ts.tv_nsec;
+}
+
+// Read and write syscalls issued by this thread so far, from the kernel's
+// per-task I/O accounting. The read that fetches them is counted only
+// after it returns, so it shows up in the next sample.
+static uint64_t threadRWCalls() {
+    int fd = open("/proc/thread-self/io", O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return 0;
+    char buf[256];
+    ssize_t n = read(fd, buf, sizeof(buf) - 1);
+    close(fd);
+    if (n <= 0) return 0;
+    buf[n] = '\0';
+
+    uint64_t total = 0;
+    for (const char* key : {"syscr: ", "syscw: "}) {
+        if (const char* p = strstr(buf, key)) {
+            p += strlen(key);
+            total += parseNumber<uint64_t>(std::string_view(p, strcspn(p, "\n"))).value_or(0);
+        }
+    }
+    return total;
+}
+
+void Stopwatch::start() {
+    rw_calls_ = threadRWCalls();
+    cpu_ns_ = clockNs(CLOCK_THREAD_CPUTIME_ID);
+    wall_ns_ = clockNs(CLOCK_MONOTONIC);
+}
+
+Timing Stopwatch::stop(std::string name) const {
+    Timing t;
+    t.wall_ns = clockNs(CLOCK_MONOTONIC) - wall_ns_;
+    t.cpu_ns = clockNs(CLOCK_THREAD_CPUTIME_ID) - cpu_ns_;
+    uint64_t rw_calls = threadRWCalls();
+    t.rw_calls = rw_calls > rw_calls_ ? rw_calls - rw_calls_ - 1 : 0;  // Minus start()'s own read
+    t.name = std::move(name);
+    return t;
+}
 
 // -------------------- BASIC --------------------
 
-void Fetcher::fetchBasicInfo() {
+template <class Alloc>
+void BasicFetcher<Alloc>::fetchBasicInfo() {
     if (passwd* pw = getpwuid(getuid()))
         info_.username = pw->pw_name;
 
@@ -73,29 +1102,30 @@ void Fetcher::fetchBasicInfo() {
 
 // -------------------- OS / KERNEL --------------------
 
-void Fetcher::fetchOSInfo() {
-    const fs::path os_release = "/etc/os-release";
-    if (!fs::exists(os_release)) return;
+template <class Alloc>
+void BasicFetcher<Alloc>::fetchOSInfo() {
+    char buf[4096];
+    std::string_view os_release = readSmallFile(AT_FDCWD, "/etc/os-release", buf, sizeof(buf));
+    if (os_release.empty()) return;
 
-    std::ifstream f(os_release);
-    std::string line;
-    while (std::getline(f, line)) {
+    forEachLine(os_release, [this](std::string_view line) {
         if (line.starts_with("NAME="))
             info_.os_name = line.substr(5);
         else if (line.starts_with("VERSION="))
             info_.os_version = line.substr(8);
         else if (line.starts_with("VERSION_CODENAME="))
             info_.os_codename = line.substr(17);
-    }
+    });
     // Remove quotes
-    auto remove_quotes = [](std::string& s) {
+    auto remove_quotes = [](String& s) {
         s.erase(std::remove(s.begin(), s.end(), '"'), s.end());
     };
     remove_quotes(info_.os_name);
     remove_quotes(info_.os_version);
 }
 
-void Fetcher::fetchKernelInfo() {
+template <class Alloc>
+void BasicFetcher<Alloc>::fetchKernelInfo() {
     struct utsname uts;
     if (uname(&uts) == 0) {
         info_.kernel = std::string(uts.sysname) + " " + uts.release;
@@ -105,25 +1135,40 @@ void Fetcher::fetchKernelInfo() {
 
 // -------------------- HOST --------------------
 
-void Fetcher::fetchHostInfo() {
-    const fs::path dmi_path = "/sys/devices/virtual/dmi/id";
-    if (!fs::exists(dmi_path)) return;
+template <class Alloc>
+void BasicFetcher<Alloc>::fetchHostInfo() {
+    Dir dmi("/sys/devices/virtual/dmi/id");
+    if (!dmi) return;
 
-    info_.model = readFirstLine(dmi_path / "product_family");
-    info_.manufacturer = readFirstLine(dmi_path / "sys_vendor");
-    info_.bios_version = readFirstLine(dmi_path / "bios_version");
-    info_.board_name = readFirstLine(dmi_path / "board_name");
+    AttrBatch batch;
+    for (const char* name : {"product_family", "sys_vendor", "bios_version", "board_name"})
+        batch.add(dmi.fd(), name);
+    batch.run();
+    info_.model = batch.get(0);
+    info_.manufacturer = batch.get(1);
+    info_.bios_version = batch.get(2);
+    info_.board_name = batch.get(3);
 }
 
 // -------------------- CPU --------------------
 
-void Fetcher::fetchCPUInfo() {
-    std::ifstream f("/proc/cpuinfo");
+// Identity only; everything here is fixed until the next reboot
+template <class Alloc>
+void BasicFetcher<Alloc>::fetchCPUInfo() {
+    // Counters below accumulate; start clean on every fetch
+    info_.cpu.model.clear();
+    info_.cpu.vendor.clear();
+    info_.cpu.core_count = 0;
+    info_.cpu.thread_count = 0;
+    info_.cpu.max_freq_ghz = 0.0;
+    info_.cpu.current_freq_ghz = 0.0;
+
+    LineReader f("/proc/cpuinfo");
     std::string line;
     bool found_model = false;
     bool found_vendor = false;
     
-    while (std::getline(f, line)) {
+    while (f.getline(line)) {
         if (!found_model && line.starts_with("model name")) {
             info_.cpu.model = trim(line.substr(line.find(':') + 1));
             found_model = true;
@@ -139,105 +1184,446 @@ void Fetcher::fetchCPUInfo() {
             info_.cpu.thread_count++;
         }
         else if (line.starts_with("cpu cores")) {
-            info_.cpu.core_count = std::stoi(trim(line.substr(line.find(':') + 1)));
+            if (auto cores = parse<int>("cpu cores", std::string_view(line).substr(line.find(':') + 1)))
+                info_.cpu.core_count = *cores;
         }
         else if (line.starts_with("cpu MHz")) {
-            std::string freq = trim(line.substr(line.find(':') + 1));
-            info_.cpu.current_freq_ghz = std::stod(freq) / 1000.0;
+            if (auto mhz = parse<double>("cpu MHz", std::string_view(line).substr(line.find(':') + 1)))
+                info_.cpu.current_freq_ghz = *mhz / 1000.0;
         }
         
         // Stop after first processor block if we have model and vendor
         if (found_model && found_vendor && line.empty()) break;
     }
 
-    const fs::path freq_path = "/sys/devices/system/cpu/cpu0/cpufreq/cpuinfo_max_freq";
-    if (fs::exists(freq_path)) {
-        std::string freq = readFirstLine(freq_path);
-        if (!freq.empty())
-            info_.cpu.max_freq_ghz = std::stod(freq) / 1e6;
+    char buf[64];
+    std::string_view freq = readAttr("/sys/devices/system/cpu/cpu0/cpufreq/cpuinfo_max_freq", buf, sizeof(buf));
+    if (auto khz = parse<double>("cpuinfo_max_freq", freq))
+        info_.cpu.max_freq_ghz = *khz / 1e6;
+
+    // The per-CPU block is sized here, once, along with the topology,
+    // which stays put while the system runs
+    CPUMetrics& per_cpu = info_.cpu.per_cpu;
+    per_cpu.resize(0);
+    per_cpu.resize(presentCPUs());
+
+    AttrBatch topology;
+    for (size_t i = 0; i < per_cpu.size(); i++) {
+        std::string dir = "/sys/devices/system/cpu/cpu" + std::to_string(i) + "/topology/";
+        topology.add(AT_FDCWD, dir + "physical_package_id");
+        topology.add(AT_FDCWD, dir + "core_id");
     }
-    
-    // Get core frequencies
-    for (int i = 0; ; i++) {
-        const fs::path core_freq_path = "/sys/devices/system/cpu/cpu" + std::to_string(i) + "/cpufreq/scaling_cur_freq";
-        if (!fs::exists(core_freq_path)) break;
-        
-        std::string freq = readFirstLine(core_freq_path);
-        if (!freq.empty()) {
-            info_.cpu.core_freqs.push_back(std::stod(freq) / 1e6);
-        }
+    topology.run();
+    for (size_t i = 0; i < per_cpu.size(); i++) {
+        per_cpu.package[i] = parse<int32_t>("physical_package_id", topology.get(2 * i)).value_or(-1);
+        per_cpu.core[i] = parse<int32_t>("core_id", topology.get(2 * i + 1)).value_or(-1);
     }
-    
+
+    // One cpulist per NUMA node; kernels built without NUMA have none
+    Dir nodes("/sys/devices/system/node");
+    nodes.forEach([&](std::string_view name) {
+        if (!name.starts_with("node")) return;
+        auto node = parseNumber<int32_t>(name.substr(4));
+        if (!node) return;  // "possible", "online", ...
+        char list[1024];
+        std::string_view cpus = nodes.attr((std::string(name) + "/cpulist").c_str(), list, sizeof(list));
+        bool ok = forEachInCPUList(cpus, [&](unsigned id) {
+            if (id < per_cpu.size()) per_cpu.node[id] = *node;
+        });
+        if (!ok) parseError("cpulist", cpus);
+    });
+}
+
+// One past the highest CPU id in "0-7", or "0-3,5-7" with holes
+template <class Alloc>
+size_t BasicFetcher<Alloc>::presentCPUs() {
+    char buf[1024];
+    std::string_view present = readCachedAttr("/sys/devices/system/cpu/present", buf, sizeof(buf));
+    size_t count = 0;
+    if (!forEachInCPUList(present, [&count](unsigned id) { count = id + 1; }))
+        parseError("present", present);
+    return count;
+}
+
+// State the per-CPU samples carry from one refresh to the next
+template <class Alloc>
+struct BasicFetcher<Alloc>::CPUSamples {
+    std::vector<char> stat;              // /proc/stat, reused
+    std::vector<uint64_t> busy, total;   // Per CPU, ticks at the last sample
+
+    bool sensors_found = false;
+    std::vector<std::string> sensors;    // hwmon temp*_input paths
+    std::vector<int32_t> sensor_of;      // Per CPU, index into sensors or -1
+};
+
+constexpr float kUnknown = std::numeric_limits<float>::quiet_NaN();
+
+// Clocks, load and temperatures of every CPU, which move all the time
+template <class Alloc>
+void BasicFetcher<Alloc>::fetchCPUFrequencies() {
     info_.cpu.architecture = info_.architecture;
+    CPUMetrics& per_cpu = info_.cpu.per_cpu;
+    if (per_cpu.size() == 0)
+        per_cpu.resize(presentCPUs());
+    if (!cpu_samples_)
+        cpu_samples_ = std::make_unique<CPUSamples>();
+
+    // Offline CPUs have no clock, load or temperature to read. Without
+    // hotplug support there is no "online" file and all of them are up.
+    char buf[1024];
+    std::string_view online = readCachedAttr("/sys/devices/system/cpu/online", buf, sizeof(buf));
+    std::fill(per_cpu.online.begin(), per_cpu.online.end(), online.empty() ? 1 : 0);
+    bool ok = forEachInCPUList(online, [&](unsigned id) {
+        if (id < per_cpu.size()) per_cpu.online[id] = 1;
+    });
+    if (!ok) parseError("online", online);
+
+    sampleCPUClocks();
+    sampleCPULoad();
+    sampleCPUTemperatures();
+}
+
+// scaling_cur_freq of every online CPU
+template <class Alloc>
+void BasicFetcher<Alloc>::sampleCPUClocks() {
+    CPUMetrics& per_cpu = info_.cpu.per_cpu;
+    std::fill(per_cpu.freq_ghz.begin(), per_cpu.freq_ghz.end(), kUnknown);
+
+    // cpu0 alone first: without cpufreq there is nothing to batch
+    auto freqPath = [](size_t cpu) {
+        return "/sys/devices/system/cpu/cpu" + std::to_string(cpu) + "/cpufreq/scaling_cur_freq";
+    };
+    char buf[64];
+    auto khz = parse<double>("scaling_cur_freq", readCachedAttr(freqPath(0), buf, sizeof(buf)));
+    if (!khz) return;
+    info_.cpu.current_freq_ghz = *khz / 1e6;
+    if (per_cpu.size() == 0) return;
+    per_cpu.freq_ghz[0] = static_cast<float>(*khz / 1e6);
+
+    AttrBatch batch;
+    std::vector<size_t> ids;
+    for (size_t i = 1; i < per_cpu.size(); i++) {
+        if (!per_cpu.online[i]) continue;
+        batch.add(AT_FDCWD, freqPath(i));
+        ids.push_back(i);
+    }
+    readCachedBatch(batch.requests());
+    for (size_t b = 0; b < batch.size(); b++) {
+        if (auto f = parse<double>("scaling_cur_freq", batch.get(b)))
+            per_cpu.freq_ghz[ids[b]] = static_cast<float>(*f / 1e6);
+    }
+}
+
+// Busy share of every CPU from its /proc/stat ticks: since the last
+// sample when there is one, else since boot
+template <class Alloc>
+void BasicFetcher<Alloc>::sampleCPULoad() {
+    CPUMetrics& per_cpu = info_.cpu.per_cpu;
+    CPUSamples& samples = *cpu_samples_;
+    std::fill(per_cpu.utilization.begin(), per_cpu.utilization.end(), kUnknown);
+    samples.busy.resize(per_cpu.size());
+    samples.total.resize(per_cpu.size());
+
+    // The cpuN lines come first and stay well under 256 bytes each; the
+    // interrupt counters after them are not wanted
+    samples.stat.resize(4096 + 256 * per_cpu.size());
+    ssize_t n = files_->read("/proc/stat", samples.stat.data(), samples.stat.size());
+    if (n <= 0) return;
+
+    forEachLine(std::string_view(samples.stat.data(), n), [&](std::string_view line) {
+        // "cpu3 4705 356 584 3699 23 23 0 0 0 0": user nice system idle
+        // iowait irq softirq steal, then guest time already in user
+        if (line.size() < 4 || !line.starts_with("cpu") || line[3] < '0' || line[3] > '9') return;
+        size_t space = line.find(' ');
+        auto id = parse<unsigned>("stat", line.substr(3, space - 3));
+        if (!id || *id >= per_cpu.size() || space == std::string_view::npos) return;
+
+        std::string_view rest = line.substr(space + 1);
+        uint64_t ticks[8];
+        for (uint64_t& t : ticks) {
+            size_t end = rest.find(' ');
+            auto value = parse<uint64_t>("stat", rest.substr(0, end));
+            if (!value) return;
+            t = *value;
+            rest.remove_prefix(end == std::string_view::npos ? rest.size() : end + 1);
+        }
+        uint64_t total = 0;
+        for (uint64_t t : ticks) total += t;
+        uint64_t busy = total - ticks[3] - ticks[4];
+
+        // Counters restart when a CPU comes back online
+        uint64_t busy_delta = busy, total_delta = total;
+        if (samples.total[*id] > 0 && total > samples.total[*id] && busy >= samples.busy[*id]) {
+            busy_delta = busy - samples.busy[*id];
+            total_delta = total - samples.total[*id];
+        }
+        if (total_delta > 0)
+            per_cpu.utilization[*id] = std::min(1.0f, static_cast<float>(busy_delta) / total_delta);
+        samples.busy[*id] = busy;
+        samples.total[*id] = total;
+    });
+}
+
+// hwmon inputs for every CPU: coretemp has one per core and one per
+// package, k10temp and zenpower one per package (Tdie, or Tctl, which some
+// parts offset). AMD packages are numbered in hwmon order, which is the
+// order the kernel probes them in.
+template <class Metrics>
+static void findCPUSensors(const Metrics& per_cpu, std::vector<std::string>& sensors,
+                           std::vector<int32_t>& sensor_of) {
+    struct Sensor {
+        int32_t package;
+        int32_t core;  // -1 for the whole package
+    };
+    std::vector<Sensor> found;
+    sensors.clear();
+
+    Dir hwmon("/sys/class/hwmon");
+    std::vector<std::string> names;
+    hwmon.forEach([&](std::string_view name) { names.emplace_back(name); });
+    // Directory order is not probe order: hwmon10 comes after hwmon9
+    std::sort(names.begin(), names.end(), [](const std::string& a, const std::string& b) {
+        return a.size() != b.size() ? a.size() < b.size() : a < b;
+    });
+
+    int32_t amd_package = 0;
+    for (const std::string& name : names) {
+        Dir dev(hwmon, name.c_str());
+        char buf[256];
+        std::string driver(dev.attr("name", buf, sizeof(buf)));
+        std::string base = "/sys/class/hwmon/" + name + "/";
+
+        if (driver == "coretemp") {
+            // The platform device is coretemp.<package>
+            char link[256];
+            ssize_t n = readlinkat(dev.fd(), "device", link, sizeof(link) - 1);
+            std::string_view target(link, n > 0 ? n : 0);
+            auto package = parseNumber<int32_t>(target.substr(target.find_last_of('.') + 1));
+            if (!package) continue;
+            dev.forEach([&](std::string_view file) {
+                if (!file.ends_with("_label")) return;
+                std::string_view label = dev.attr(std::string(file).c_str(), buf, sizeof(buf));
+                std::optional<int32_t> core = -1;
+                if (label.starts_with("Core "))
+                    core = parseNumber<int32_t>(label.substr(5));
+                else if (!label.starts_with("Package id "))
+                    return;
+                if (!core) return;
+                found.push_back({*package, *core});
+                sensors.push_back(base + std::string(file.substr(0, file.size() - 6)) + "_input");
+            });
+        } else if (driver == "k10temp" || driver == "zenpower") {
+            std::string input;
+            dev.forEach([&](std::string_view file) {
+                if (!file.ends_with("_label")) return;
+                std::string_view label = dev.attr(std::string(file).c_str(), buf, sizeof(buf));
+                if (label == "Tdie" || (label == "Tctl" && input.empty()))
+                    input = base + std::string(file.substr(0, file.size() - 6)) + "_input";
+            });
+            if (input.empty()) continue;
+            found.push_back({amd_package++, -1});
+            sensors.push_back(std::move(input));
+        }
+    }
+
+    sensor_of.assign(per_cpu.size(), -1);
+    for (size_t i = 0; i < per_cpu.size(); i++) {
+        for (size_t s = 0; s < found.size(); s++) {
+            if (found[s].package != per_cpu.package[i]) continue;
+            if (found[s].core == per_cpu.core[i]) {
+                sensor_of[i] = static_cast<int32_t>(s);
+                break;
+            }
+            if (found[s].core == -1 && sensor_of[i] < 0)
+                sensor_of[i] = static_cast<int32_t>(s);
+        }
+    }
+}
+
+// Looked for once, then one pread per sensor, kept open, per sample
+template <class Alloc>
+void BasicFetcher<Alloc>::sampleCPUTemperatures() {
+    CPUMetrics& per_cpu = info_.cpu.per_cpu;
+    CPUSamples& samples = *cpu_samples_;
+    std::fill(per_cpu.temp_c.begin(), per_cpu.temp_c.end(), kUnknown);
+    if (!samples.sensors_found || samples.sensor_of.size() != per_cpu.size()) {
+        findCPUSensors(per_cpu, samples.sensors, samples.sensor_of);
+        samples.sensors_found = true;
+    }
+    if (samples.sensors.empty()) return;
+
+    AttrBatch batch;
+    for (const std::string& path : samples.sensors)
+        batch.add(AT_FDCWD, path);
+    readCachedBatch(batch.requests());
+    std::vector<float> celsius(batch.size(), kUnknown);
+    for (size_t s = 0; s < batch.size(); s++) {
+        if (auto millis = parse<int64_t>("temp_input", batch.get(s)))
+            celsius[s] = *millis / 1000.0f;
+    }
+    for (size_t i = 0; i < per_cpu.size(); i++) {
+        if (per_cpu.online[i] && samples.sensor_of[i] >= 0)
+            per_cpu.temp_c[i] = celsius[samples.sensor_of[i]];
+    }
+}
+
+// -------------------- PER-CPU METRICS --------------------
+
+template <class Alloc>
+void BasicCPUMetrics<Alloc>::resize(size_t n) {
+    freq_ghz.resize(n, kUnknown);
+    temp_c.resize(n, kUnknown);
+    utilization.resize(n, kUnknown);
+    online.resize(n, 0);
+    package.resize(n, -1);
+    core.resize(n, -1);
+    node.resize(n, -1);
+}
+
+// Four floats at a time through the GCC/Clang vector extensions, one
+// SSE2 or NEON register. Operators, comparisons and ?: work element-wise,
+// and a comparison yields all-ones or zero per lane.
+constexpr size_t kLanes = 4;
+typedef float Floats __attribute__((vector_size(kLanes * sizeof(float))));
+typedef int32_t Ints __attribute__((vector_size(kLanes * sizeof(int32_t))));
+
+static Floats loadLanes(const float* p) {
+    Floats v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+MetricSummary summarize(std::span<const float> values) {
+    constexpr float kInf = std::numeric_limits<float>::infinity();
+    Floats lo = Floats{} + kInf, hi = Floats{} - kInf, sum = {}, count = {};
+    const Floats zero = {}, one = zero + 1.0f;
+
+    // Comparisons with NaN are false, so a NaN never wins min or max
+    size_t i = 0;
+    for (; i + kLanes <= values.size(); i += kLanes) {
+        Floats v = loadLanes(values.data() + i);
+        Ints known = v == v;
+        lo = v < lo ? v : lo;
+        hi = v > hi ? v : hi;
+        sum += known ? v : zero;
+        count += known ? one : zero;
+    }
+
+    MetricSummary out;
+    out.min = kInf;
+    out.max = -kInf;
+    float total = 0.0f;
+    for (size_t l = 0; l < kLanes; l++) {
+        out.min = std::min(out.min, lo[l]);
+        out.max = std::max(out.max, hi[l]);
+        total += sum[l];
+        out.count += static_cast<size_t>(count[l]);
+    }
+    for (; i < values.size(); i++) {
+        float v = values[i];
+        if (std::isnan(v)) continue;
+        out.min = std::min(out.min, v);
+        out.max = std::max(out.max, v);
+        total += v;
+        out.count++;
+    }
+    if (out.count == 0) {
+        out.min = out.max = out.avg = kUnknown;
+        return out;
+    }
+    out.avg = total / out.count;
+    return out;
+}
+
+std::vector<uint32_t> histogram(std::span<const float> values, float lo, float hi, size_t buckets) {
+    std::vector<uint32_t> counts(buckets);
+    if (buckets == 0 || !(hi > lo)) return counts;
+    const float scale = buckets / (hi - lo);
+    const float last = static_cast<float>(buckets - 1);
+    const Floats zero = {}, top = zero + last;
+
+    // Bins are worked out four at a time; only the counting is scalar.
+    // NaN lands in bin -1, which is skipped.
+    auto count = [&](Floats v, size_t n) {
+        Floats b = (v - lo) * scale;
+        b = b < zero ? zero : b;
+        b = b > top ? top : b;
+        Ints bin = __builtin_convertvector(b, Ints);
+        bin = v == v ? bin : Ints{} - 1;
+        for (size_t l = 0; l < n; l++) {
+            if (bin[l] >= 0) counts[bin[l]]++;
+        }
+    };
+    size_t i = 0;
+    for (; i + kLanes <= values.size(); i += kLanes)
+        count(loadLanes(values.data() + i), kLanes);
+    if (i < values.size()) {
+        float tail[kLanes];
+        std::fill(std::begin(tail), std::end(tail), kUnknown);
+        std::copy(values.begin() + i, values.end(), tail);
+        count(loadLanes(tail), values.size() - i);
+    }
+    return counts;
 }
 
 // -------------------- GPU --------------------
 
-void Fetcher::fetchGPUInfo() {
+template <class Alloc>
+void BasicFetcher<Alloc>::fetchGPUInfo() {
     info_.gpus.clear();
-    const fs::path drm_path = "/sys/class/drm";
-    if (!fs::exists(drm_path)) return;
-
-    // Map vendor IDs to names
-    auto get_vendor_name = [](const std::string& vid) -> std::pair<std::string, bool> {
-        if (vid == "0x8086") return {"Intel", true};
-        if (vid == "0x10de") return {"NVIDIA", false};
-        if (vid == "0x1002") return {"AMD", false};
-        if (vid == "0x106b") return {"Apple", true};
+    Dir drm("/sys/class/drm");
+    if (!drm) return;
+
+    // Map PCI vendor IDs to names
+    auto get_vendor_name = [](std::string_view vid) -> std::pair<std::string_view, bool> {
+        if (vid == "8086") return {"Intel", true};
+        if (vid == "10de") return {"NVIDIA", false};
+        if (vid == "1002") return {"AMD", false};
+        if (vid == "106b") return {"Apple", true};
         return {"Unknown", false};
     };
 
-    for (const auto& entry : fs::directory_iterator(drm_path)) {
-        std::string name = entry.path().filename().string();
+    drm.forEach([&](std::string_view name) {
         // Skip connectors (those with dash) and control devices
-        if (!name.starts_with("card") || name.find('-') != std::string::npos)
-            continue;
+        if (!name.starts_with("card") || name.find('-') != std::string_view::npos)
+            return;
 
-        GPU gpu;
-        const fs::path device_path = entry.path() / "device";
-        
-        // Vendor
-        std::string vid = readFirstLine(device_path / "vendor");
+        // Built in the list's resource, so moving it in moves the strings too
+        GPU gpu(info_.gpus.get_allocator());
+        std::string device = std::string(name) + "/device/";
+        char buf[4096];
+
+        // Driver and "VVVV:DDDD" PCI IDs from the parent device's uevent;
+        // platform GPUs have no PCI_ID and stay Unknown
+        std::string vid, did;
+        forEachUevent(drm.file((device + "uevent").c_str(), buf, sizeof(buf)),
+                      [&](std::string_view key, std::string_view value) {
+            if (key == "DRIVER") {
+                gpu.driver = value;
+            } else if (key == "PCI_ID" && value.size() == 9 && value[4] == ':') {
+                for (char c : value.substr(0, 4)) vid += static_cast<char>(tolower(c));
+                for (char c : value.substr(5)) did += static_cast<char>(tolower(c));
+            }
+        });
         auto [vendor, is_integrated] = get_vendor_name(vid);
         gpu.vendor = vendor;
         gpu.is_integrated = is_integrated;
-        
-        // Model - try multiple possible locations
-        const std::vector<fs::path> model_paths = {
-            device_path / "product_name",
-            device_path / "model",
-            device_path / "device"  // device ID file
-        };
-        
-        for (const auto& model_path : model_paths) {
-            if (fs::exists(model_path)) {
-                std::string model = readFirstLine(model_path);
-                if (!model.empty()) {
-                    gpu.model = model;
-                    break;
-                }
-            }
-        }
+
+        // Model: amdgpu alone names the board, everyone else gets the
+        // device ID, as the old "device" attribute gave it
+        if (vid == "1002")
+            gpu.model = drm.attr((device + "product_name").c_str(), buf, sizeof(buf));
+        if (gpu.model.empty() && !did.empty())
+            gpu.model = "0x" + did;
         
         // Fallback to vendor + "GPU"
         if (gpu.model.empty()) {
-            gpu.model = gpu.vendor + " GPU";
-        }
-        
-        // Try to get driver
-        const fs::path driver_path = entry.path() / "device" / "uevent";
-        if (fs::exists(driver_path)) {
-            std::ifstream uevent(driver_path);
-            std::string line;
-            while (std::getline(uevent, line)) {
-                if (line.starts_with("DRIVER=")) {
-                    gpu.driver = line.substr(7);
-                    break;
-                }
-            }
+            gpu.model = gpu.vendor.view();
+            gpu.model += " GPU";
         }
         
-        // Avoid duplicates by checking if we already have this GPU
+        // Avoid duplicates by checking if we already have this GPU; the
+        // vendor check is a pointer compare
         auto it = std::find_if(info_.gpus.begin(), info_.gpus.end(),
             [&gpu](const GPU& existing) {
                 return existing.vendor == gpu.vendor && 
@@ -245,248 +1631,601 @@ void Fetcher::fetchGPUInfo() {
             });
         
         if (it == info_.gpus.end()) {
-            info_.gpus.push_back(gpu);
+            info_.gpus.push_back(std::move(gpu));
         }
-    }
+    });
 }
 
 // -------------------- MEMORY / SWAP --------------------
 
-void Fetcher::fetchMemoryInfo() {
-    struct sysinfo si;
-    if (sysinfo(&si) == 0) {
-        info_.memory.total_bytes = si.totalram * si.mem_unit;
-        info_.memory.free_bytes  = si.freeram * si.mem_unit;
-        info_.memory.used_bytes  = (info_.memory.total_bytes - info_.memory.free_bytes)/2;
-        info_.memory.available_bytes = info_.memory.free_bytes; // Simplified
-        info_.memory.usage_percent = (info_.memory.total_bytes > 0) ? 
-            static_cast<int>((info_.memory.used_bytes * 100) / info_.memory.total_bytes) : 0;
-    }
+// Memory and swap in one pass over /proc/meminfo, kept open so sampling
+// every second costs a single pread. Values there are in KiB.
+template <class Alloc>
+void BasicFetcher<Alloc>::fetchMemoryInfo() {
+    enum { kTotal, kFree, kAvailable, kBuffers, kCached, kSReclaimable, kShmem, kSwapTotal, kSwapFree };
+    static constexpr std::string_view keys[] = {
+        "MemTotal", "MemFree", "MemAvailable", "Buffers", "Cached", "SReclaimable", "Shmem",
+        "SwapTotal", "SwapFree",
+    };
+
+    char buf[8192];
+    ssize_t n = files_->read("/proc/meminfo", buf, sizeof(buf));
+    if (n <= 0) return;
+
+    uint64_t kib[std::size(keys)] = {};
+    uint32_t found = 0;
+    forEachLine(std::string_view(buf, n), [&](std::string_view line) {
+        size_t colon = line.find(':');
+        if (colon == std::string_view::npos) return;
+        std::string_view key = line.substr(0, colon);
+        for (size_t i = 0; i < std::size(keys); i++) {
+            if (key != keys[i]) continue;
+            // "  16318208 kB"
+            std::string_view value = trimView(line.substr(colon + 1));
+            if (auto n = parse<uint64_t>(key, value.substr(0, value.find(' ')))) {
+                kib[i] = *n;
+                found |= 1u << i;
+            }
+            break;
+        }
+    });
+    if (!(found & (1u << kTotal))) return;
+
+    Memory& mem = info_.memory;
+    mem.total_bytes = kib[kTotal] * 1024;
+    mem.free_bytes = kib[kFree] * 1024;
+    mem.buffers_bytes = kib[kBuffers] * 1024;
+    // Page cache the kernel can drop: shmem lives there but cannot go
+    uint64_t cached = kib[kCached] + kib[kSReclaimable];
+    mem.cached_bytes = (cached > kib[kShmem] ? cached - kib[kShmem] : 0) * 1024;
+    // MemAvailable is the kernel's own estimate (3.14+); before it, free
+    // plus what the caches could give back
+    mem.available_bytes = (found & (1u << kAvailable))
+        ? kib[kAvailable] * 1024
+        : mem.free_bytes + mem.buffers_bytes + mem.cached_bytes;
+    mem.available_bytes = std::min(mem.available_bytes, mem.total_bytes);
+    mem.used_bytes = mem.total_bytes - mem.available_bytes;
+    mem.usage_percent = (mem.total_bytes > 0) ? 
+        static_cast<int>((mem.used_bytes * 100) / mem.total_bytes) : 0;
+
+    Swap& swap = info_.swap;
+    swap.total_bytes = kib[kSwapTotal] * 1024;
+    swap.free_bytes = std::min(kib[kSwapFree] * 1024, swap.total_bytes);
+    swap.used_bytes = swap.total_bytes - swap.free_bytes;
+    swap.usage_percent = (swap.total_bytes > 0) ? 
+        static_cast<int>((swap.used_bytes * 100) / swap.total_bytes) : 0;
+}
+
+// -------------------- DISK --------------------
+
+// One line of /proc/self/mountinfo. Views point into the file buffer.
+struct MountEntry {
+    unsigned id = 0;
+    unsigned major = 0;
+    unsigned minor = 0;
+    std::string_view root;          // Path inside the filesystem: "/" unless a bind or subvolume mount
+    std::string_view mount_point;   // Still octal-escaped
+    std::string_view type;
+    std::string_view source;
+};
+
+// "36 35 98:0 /mnt1 /mnt2 rw,noatime master:1 - ext3 /dev/root rw,errors=continue"
+static bool parseMountInfo(std::string_view line, MountEntry& m) {
+    auto field = [&line]() {
+        size_t end = line.find(' ');
+        std::string_view f = line.substr(0, end);
+        line.remove_prefix(end == std::string_view::npos ? line.size() : end + 1);
+        return f;
+    };
+    auto number = [](std::string_view f, unsigned& out) {
+        auto n = parseNumber<unsigned>(f);
+        if (n) out = *n;
+        return n.has_value();
+    };
+
+    std::string_view id = field();
+    field();  // Parent ID
+    std::string_view dev = field();
+    m.root = field();
+    m.mount_point = field();
+    size_t colon = dev.find(':');
+    if (!number(id, m.id) || colon == std::string_view::npos ||
+        !number(dev.substr(0, colon), m.major) || !number(dev.substr(colon + 1), m.minor))
+        return false;
+
+    // Per-mount options and a variable number of optional fields, up to "-"
+    size_t dash = line.find(" - ");
+    if (dash == std::string_view::npos) return false;
+    line.remove_prefix(dash + 3);
+    m.type = field();
+    m.source = field();
+    return !m.type.empty();
 }
 
-void Fetcher::fetchSwapInfo() {
-    struct sysinfo si;
-    if (sysinfo(&si) == 0) {
-        info_.swap.total_bytes = si.totalswap * si.mem_unit;
-        info_.swap.free_bytes  = si.freeswap * si.mem_unit;
-        info_.swap.used_bytes  = info_.swap.total_bytes - info_.swap.free_bytes;
-        info_.swap.usage_percent = (info_.swap.total_bytes > 0) ? 
-            static_cast<int>((info_.swap.used_bytes * 100) / info_.swap.total_bytes) : 0;
+// The kernel writes space, tab, newline and backslash in mount points as
+// \ooo octal escapes
+static std::string unescapeMountPoint(std::string_view path) {
+    std::string out;
+    out.reserve(path.size());
+    for (size_t i = 0; i < path.size(); i++) {
+        if (path[i] == '\\' && i + 3 < path.size() &&
+            std::all_of(path.begin() + i + 1, path.begin() + i + 4, [](char c) { return c >= '0' && c <= '7'; })) {
+            out += static_cast<char>((path[i + 1] - '0') * 64 + (path[i + 2] - '0') * 8 + (path[i + 3] - '0'));
+            i += 3;
+        } else {
+            out += path[i];
+        }
     }
+    return out;
 }
 
-// -------------------- DISK --------------------
+// Kernel-internal and memory-backed filesystems: never a disk
+static bool isPseudoFilesystem(std::string_view type) {
+    static constexpr std::string_view pseudo[] = {
+        "autofs", "binfmt_misc", "bpf", "cgroup", "cgroup2", "configfs", "debugfs",
+        "devpts", "devtmpfs", "efivarfs", "fusectl", "hugetlbfs", "mqueue", "nsfs",
+        "overlay", "proc", "pstore", "ramfs", "rpc_pipefs", "securityfs", "selinuxfs",
+        "sysfs", "tmpfs", "tracefs",
+    };
+    return std::find(std::begin(pseudo), std::end(pseudo), type) != std::end(pseudo);
+}
+
+// Network and FUSE filesystems: statvfs on them waits for a server or a
+// userspace daemon that may never answer
+static bool mayHang(std::string_view type) {
+    static constexpr std::string_view remote[] = {
+        "9p", "afs", "ceph", "cifs", "davfs", "glusterfs", "lustre", "nfs", "nfs4", "smb3", "smbfs",
+    };
+    return type.starts_with("fuse") || std::find(std::begin(remote), std::end(remote), type) != std::end(remote);
+}
+
+template <class D>
+static void fillUsage(D& disk, const struct statvfs& st) {
+    disk.total_bytes = st.f_blocks * st.f_frsize;
+    disk.free_bytes = st.f_bfree * st.f_frsize;
+    disk.available_bytes = st.f_bavail * st.f_frsize;
+    disk.used_bytes = disk.total_bytes - disk.free_bytes;
+    disk.usage_percent = (disk.total_bytes > 0) ? 
+        static_cast<int>((disk.used_bytes * 100) / disk.total_bytes) : 0;
+}
+
+// Mount points whose statvfs readDiskUsage gave up on and that has not
+// returned yet. The Fetcher leaves them alone until it does, so a hung
+// mount ties up one thread for good instead of one more per fetch.
+template <class Alloc>
+struct BasicFetcher<Alloc>::StuckMounts {
+    std::mutex mutex;
+    std::unordered_set<std::string> paths;
+};
+
+// statvfs jobs for a set of mounts, shared with the threads running them,
+// which can outlive the call
+template <class Alloc>
+struct BasicFetcher<Alloc>::StatJobs {
+    enum State : uint8_t { kQueued, kRunning, kDone, kFailed, kAbandoned };
+
+    std::mutex mutex;
+    std::condition_variable progress;
+    std::vector<std::string> paths;
+    std::vector<struct statvfs> results;
+    std::vector<State> states;
+    std::vector<std::chrono::steady_clock::time_point> started;
+    size_t next = 0;
+    size_t settled = 0;
+    std::shared_ptr<StuckMounts> stuck;  // Where abandoned jobs are listed
+
+    // io::current is unset on these threads: readDiskUsage counts every
+    // statvfs started, including the ones it gives up on
+    static void work(const std::shared_ptr<StatJobs>& jobs) {
+        std::unique_lock<std::mutex> lock(jobs->mutex);
+        while (jobs->next < jobs->paths.size()) {
+            size_t i = jobs->next++;
+            jobs->states[i] = kRunning;
+            jobs->started[i] = std::chrono::steady_clock::now();
+            std::string path = jobs->paths[i];
+            lock.unlock();
+
+            struct statvfs st;
+            bool ok = io::statvfs(path.c_str(), &st) == 0;
+
+            lock.lock();
+            if (jobs->states[i] == kAbandoned) {  // Given up on meanwhile
+                std::lock_guard<std::mutex> guard(jobs->stuck->mutex);
+                jobs->stuck->paths.erase(path);
+                continue;
+            }
+            jobs->results[i] = st;
+            jobs->states[i] = ok ? kDone : kFailed;
+            jobs->settled++;
+            jobs->progress.notify_all();
+        }
+    }
+};
+
+constexpr size_t kStatThreads = 4;
+constexpr auto kStatTimeout = std::chrono::milliseconds(250);
+
+// Fills the usage of every disk, returning which ones it could read.
+// The mounts are stat'ed by a few detached threads at the same time,
+// since a local disk can stall too (a dying drive, a frozen filesystem).
+// Any statvfs that has not answered within kStatTimeout is given up on,
+// and a fresh thread takes over the rest of the queue from the stuck one.
+// Mounts given up on, now or by an earlier call still stuck, are listed
+// in Info::unavailable.
+template <class Alloc>
+std::vector<bool> BasicFetcher<Alloc>::readDiskUsage(List<Disk>& disks) {
+    std::vector<bool> ok(disks.size());
+    std::vector<size_t> queued;
+    std::vector<size_t> stuck;
+    {
+        std::lock_guard<std::mutex> lock(stuck_mounts_->mutex);
+        for (size_t i = 0; i < disks.size(); i++) {
+            const bool hung = stuck_mounts_->paths.count(std::string(disks[i].mount_point));
+            (hung ? stuck : queued).push_back(i);
+        }
+    }
 
-void Fetcher::fetchDiskInfo() {
+    auto jobs = std::make_shared<StatJobs>();
+    jobs->stuck = stuck_mounts_;
+    for (size_t i : queued)
+        jobs->paths.emplace_back(disks[i].mount_point);
+    jobs->results.resize(queued.size());
+    jobs->states.resize(queued.size(), StatJobs::kQueued);
+    jobs->started.resize(queued.size());
+    for (size_t t = 0; t < std::min(kStatThreads, queued.size()); t++)
+        std::thread(StatJobs::work, jobs).detach();
+
+    std::unique_lock<std::mutex> lock(jobs->mutex);
+    while (jobs->settled < queued.size()) {
+        // The oldest statvfs still running sets how long to wait
+        auto oldest = std::chrono::steady_clock::time_point::max();
+        for (size_t j = 0; j < queued.size(); j++) {
+            if (jobs->states[j] == StatJobs::kRunning)
+                oldest = std::min(oldest, jobs->started[j]);
+        }
+        if (oldest == std::chrono::steady_clock::time_point::max()) {
+            jobs->progress.wait(lock);
+            continue;
+        }
+        if (jobs->progress.wait_until(lock, oldest + kStatTimeout) == std::cv_status::no_timeout)
+            continue;
+
+        auto now = std::chrono::steady_clock::now();
+        for (size_t j = 0; j < queued.size(); j++) {
+            if (jobs->states[j] != StatJobs::kRunning || now - jobs->started[j] < kStatTimeout) continue;
+            jobs->states[j] = StatJobs::kAbandoned;
+            jobs->settled++;
+            {
+                std::lock_guard<std::mutex> guard(stuck_mounts_->mutex);
+                stuck_mounts_->paths.insert(jobs->paths[j]);
+            }
+            if (jobs->next < queued.size())
+                std::thread(StatJobs::work, jobs).detach();
+        }
+    }
+
+    for (size_t j = 0; j < queued.size(); j++) {
+        if (io::current && jobs->states[j] != StatJobs::kQueued) io::current->stats++;
+        if (jobs->states[j] == StatJobs::kAbandoned)
+            stuck.push_back(queued[j]);
+        if (jobs->states[j] != StatJobs::kDone) continue;
+        fillUsage(disks[queued[j]], jobs->results[j]);
+        ok[queued[j]] = true;
+    }
+    lock.unlock();
+
+    if (stuck.empty()) return ok;
+    std::sort(stuck.begin(), stuck.end());
+    std::lock_guard<std::mutex> guard(errors_mutex_);
+    for (size_t i : stuck) {
+        String& entry = info_.unavailable.emplace_back("disk ");
+        entry += disks[i].mount_point;
+    }
+    return ok;
+}
+
+template <class Alloc>
+void BasicFetcher<Alloc>::fetchDiskInfo() {
     info_.disks.clear();
-    
-    // Read mount points from /proc/mounts
-    std::ifstream mounts("/proc/mounts");
-    std::string line;
-    
-    while (std::getline(mounts, line)) {
-        std::istringstream iss(line);
-        std::string device, mount_point, type;
-        iss >> device >> mount_point >> type;
-        
-        // Skip non-physical filesystems
-        if (device.find("/dev/") != 0) continue;
-        if (type == "tmpfs" || type == "proc" || type == "sysfs" || 
-            type == "devtmpfs" || type == "cgroup" || type == "overlay") continue;
-        
-        struct statvfs st;
-        if (statvfs(mount_point.c_str(), &st) == 0) {
-            Disk disk;
-            disk.mount_point = mount_point;
-            disk.filesystem = type;
-            disk.total_bytes = st.f_blocks * st.f_frsize;
-            disk.free_bytes = st.f_bfree * st.f_frsize;
-            disk.available_bytes = st.f_bavail * st.f_frsize;
-            disk.used_bytes = disk.total_bytes - disk.free_bytes;
-            disk.usage_percent = (disk.total_bytes > 0) ? 
-                static_cast<int>((disk.used_bytes * 100) / disk.total_bytes) : 0;
-            info_.disks.push_back(disk);
+
+    // The whole mount table in one buffer; it runs to thousands of lines
+    // on container hosts
+    std::string table;
+    if (int fd = io::openat(AT_FDCWD, "/proc/self/mountinfo", O_RDONLY | O_CLOEXEC); fd >= 0) {
+        size_t len = 0;
+        ssize_t n;
+        do {
+            table.resize(len + 65536);
+            n = io::read(fd, table.data() + len, table.size() - len);
+            if (n > 0) len += n;
+        } while (n > 0);
+        close(fd);
+        table.resize(len);
+    }
+
+    // Bind mounts and btrfs subvolumes repeat a filesystem under another
+    // root: count each device once, at its first mount
+    List<Disk> candidates(info_.disks.get_allocator());
+    std::unordered_set<uint64_t> seen;
+    forEachLine(table, [&](std::string_view line) {
+        if (line.empty()) return;
+        MountEntry m;
+        if (!parseMountInfo(line, m)) {
+            parseError("mountinfo", line);
+            return;
         }
+        if (isPseudoFilesystem(m.type)) return;
+        // Block devices, plus whatever a server or FUSE daemon provides
+        if (!m.source.starts_with("/dev/") && !mayHang(m.type)) return;
+
+        uint64_t dev = (static_cast<uint64_t>(m.major) << 32) | m.minor;
+        if (!seen.insert(dev).second) return;
+
+        Disk& disk = candidates.emplace_back();
+        disk.mount_point = unescapeMountPoint(m.mount_point);
+        disk.filesystem = m.type;
+    });
+
+    std::vector<bool> ok = readDiskUsage(candidates);
+    for (size_t i = 0; i < candidates.size(); i++) {
+        // FUSE helpers like the desktop portal report no blocks at all
+        if (ok[i] && (candidates[i].total_bytes > 0 || !mayHang(candidates[i].filesystem)))
+            info_.disks.push_back(std::move(candidates[i]));
     }
 }
 
+// Re-reads usage of the mounts found by the last fetch, without going
+// through the mount table again. A mount that fails or times out keeps
+// its last values.
+template <class Alloc>
+void BasicFetcher<Alloc>::refreshDiskUsage() {
+    readDiskUsage(info_.disks);
+}
+
 // -------------------- DISPLAY --------------------
 
-void Fetcher::fetchDisplayInfo() {
+template <class Alloc>
+void BasicFetcher<Alloc>::fetchDisplayInfo() {
     info_.displays.clear();
-    const fs::path drm_path = "/sys/class/drm";
-    if (!fs::exists(drm_path)) return;
+    Dir drm("/sys/class/drm");
+    if (!drm) return;
+
+    // Look for connector directories (contain dash)
+    std::vector<std::string> connectors;
+    drm.forEach([&](std::string_view name) {
+        if (name.find('-') != std::string_view::npos)
+            connectors.emplace_back(name);
+    });
 
-    for (const auto& entry : fs::directory_iterator(drm_path)) {
-        std::string name = entry.path().filename().string();
-        // Look for connector directories (contain dash)
-        if (name.find('-') == std::string::npos) continue;
+    AttrBatch status;
+    for (const std::string& name : connectors)
+        status.add(drm.fd(), name + "/status");
+    status.run();
+
+    std::vector<size_t> connected;
+    AttrBatch modes;
+    for (size_t i = 0; i < connectors.size(); i++) {
+        if (status.get(i) != "connected") continue;
+        connected.push_back(i);
+        modes.add(drm.fd(), connectors[i] + "/modes");
+    }
+    modes.run();
+
+    for (size_t m = 0; m < connected.size(); m++) {
+        const std::string& name = connectors[connected[m]];
+        Display display(info_.displays.get_allocator());
+        display.output_name = name;
+        display.name = name;
         
-        const fs::path status_path = entry.path() / "status";
-        if (fs::exists(status_path)) {
-            std::string status = readFirstLine(status_path);
-            if (status == "connected") {
-                Display display;
-                display.output_name = name;
-                display.name = name;
-                
-                // Check if it's built-in (eDP typically is)
-                if (name.find("eDP") != std::string::npos) {
-                    display.is_builtin = true;
-                }
-                
-                // Try to get mode from modes file
-                const fs::path modes_path = entry.path() / "modes";
-                if (fs::exists(modes_path)) {
-                    std::string mode = readFirstLine(modes_path);
-                    if (!mode.empty()) {
-                        display.current_mode = mode;
-                        // Parse resolution from mode (e.g., "1920x1080")
-                        size_t x_pos = mode.find('x');
-                        if (x_pos != std::string::npos) {
-                            std::string width_str = mode.substr(0, x_pos);
-                            std::string rest = mode.substr(x_pos + 1);
-                            size_t at_pos = rest.find('@');
-                            std::string height_str = (at_pos != std::string::npos) ? 
-                                rest.substr(0, at_pos) : rest;
-                            
-                            try {
-                                display.width = std::stoi(width_str);
-                                display.height = std::stoi(height_str);
-                            } catch (...) {
-                                // Ignore conversion errors
-                            }
-                        }
-                    }
+        // Check if it's built-in (eDP typically is)
+        if (name.find("eDP") != std::string::npos) {
+            display.is_builtin = true;
+        }
+        
+        // Try to get mode from modes file
+        std::string_view mode = modes.get(m);
+        if (!mode.empty()) {
+            display.current_mode = mode;
+            // Parse resolution from mode (e.g., "1920x1080", "1920x1080i")
+            size_t x_pos = mode.find('x');
+            if (x_pos != std::string_view::npos) {
+                std::string_view height = mode.substr(x_pos + 1);
+                height = height.substr(0, height.find_first_of("@i"));
+                auto w = parse<int>("modes", mode.substr(0, x_pos));
+                auto h = parse<int>("modes", height);
+                if (w && h) {
+                    display.width = *w;
+                    display.height = *h;
                 }
-                
-                info_.displays.push_back(display);
             }
         }
+        
+        info_.displays.push_back(std::move(display));
     }
 }
 
 // -------------------- NETWORK --------------------
 
-void Fetcher::fetchNetworkInfo() {
+// Dotted-quad form of an IPv4 prefix length
+static std::string prefixToMask(unsigned prefix_len) {
+    uint32_t mask = prefix_len ? ~0u << (32 - std::min(prefix_len, 32u)) : 0;
+    return std::to_string(mask >> 24) + "." + std::to_string((mask >> 16) & 0xff) + "." +
+           std::to_string((mask >> 8) & 0xff) + "." + std::to_string(mask & 0xff);
+}
+
+// State and counters: the parts of a link that move
+template <class Nic>
+static void copyLinkStats(Nic& nic, const Link& link) {
+    nic.operstate = link.operstate;
+    nic.is_up = (nic.operstate == "up");
+    nic.rx_bytes = link.rx_bytes;
+    nic.tx_bytes = link.tx_bytes;
+    nic.rx_packets = link.rx_packets;
+    nic.tx_packets = link.tx_packets;
+    nic.rx_errors = link.rx_errors;
+    nic.tx_errors = link.tx_errors;
+    nic.rx_dropped = link.rx_dropped;
+    nic.tx_dropped = link.tx_dropped;
+}
+
+template <class Alloc>
+void BasicFetcher<Alloc>::fetchNetworkInfo() {
     info_.network_interfaces.clear();
-    const fs::path net_path = "/sys/class/net";
-    if (!fs::exists(net_path)) return;
 
-    for (const auto& entry : fs::directory_iterator(net_path)) {
-        std::string ifname = entry.path().filename().string();
-        if (ifname == "lo") continue;
-        
-        NetworkInterface nic;
-        nic.name = ifname;
-        nic.mac = readFirstLine(entry.path() / "address");
-        
-        // Get operational state
-        const fs::path operstate_path = entry.path() / "operstate";
-        if (fs::exists(operstate_path)) {
-            nic.operstate = readFirstLine(operstate_path);
-            nic.is_up = (nic.operstate == "up");
-        }
-        
-        // Check if wireless
-        const fs::path wireless_path = entry.path() / "wireless";
-        if (fs::exists(wireless_path)) {
-            nic.is_wireless = true;
-        }
-        
-        // Get IP addresses from /proc/net/fib_trie (simplified)
-        std::ifstream fib("/proc/net/fib_trie");
-        std::string line;
-        while (std::getline(fib, line)) {
-            if (line.find(ifname) != std::string::npos) {
-                size_t pos = line.find("/32 host");
-                if (pos != std::string::npos) {
-                    std::string ip = line.substr(0, pos);
-                    // Simple IPv4 check
-                    if (ip.find('.') != std::string::npos && ip != "127.0.0.1") {
-                        if (nic.ipv4.empty()) {
-                            nic.ipv4 = ip;  // Set primary IPv4
-                        }
-                        nic.ipv4_addresses.push_back(ip);
-                    }
-                }
+    // Every link with its counters in one rtnetlink dump
+    std::vector<Link> links;
+    dumpLinks(links);
+
+    Dir net("/sys/class/net");
+    std::unordered_map<int, size_t> by_index;  // ifindex -> network_interfaces
+    for (const Link& link : links) {
+        if (link.flags & IFF_LOOPBACK) continue;
+
+        NetworkInterface nic(info_.network_interfaces.get_allocator());
+        nic.name = link.name;
+        nic.mac = link.mac;
+        nic.ifindex = link.ifindex;
+        nic.mtu = link.mtu;
+        copyLinkStats(nic, link);
+
+        // Wi-Fi shows up as plain Ethernet; virtual links (veth, bridge,
+        // ...) carry a kind and are never wireless, so skip their probe
+        if (link.type == ARPHRD_ETHER && link.kind.empty())
+            nic.is_wireless = net.has((link.name + "/wireless").c_str());
+
+        by_index.emplace(link.ifindex, info_.network_interfaces.size());
+        info_.network_interfaces.push_back(std::move(nic));
+    }
+
+    // Every address of every interface in one rtnetlink dump, joined by
+    // ifindex. The dump lists primaries before their secondaries.
+    std::vector<InterfaceAddress> addresses;
+    dumpAddresses(addresses);
+    for (const InterfaceAddress& addr : addresses) {
+        auto it = by_index.find(addr.ifindex);
+        if (it == by_index.end()) continue;
+        NetworkInterface& nic = info_.network_interfaces[it->second];
+
+        if (addr.family == AF_INET) {
+            nic.ipv4_addresses.emplace_back(addr.address);
+            if (nic.ipv4.empty() && !(addr.flags & IFA_F_SECONDARY)) {
+                nic.ipv4 = addr.address;  // Set primary IPv4
+                nic.subnet_mask = prefixToMask(addr.prefix_len);
             }
+        } else if (nic.ipv6.empty() && addr.scope < RT_SCOPE_LINK &&
+                   !(addr.flags & (IFA_F_TENTATIVE | IFA_F_DEPRECATED | IFA_F_DADFAILED))) {
+            nic.ipv6 = addr.address;  // First usable global address, not fe80::
         }
-        
-        info_.network_interfaces.push_back(nic);
     }
 }
 
-// -------------------- BATTERY --------------------
+// Re-reads state and counters of every link found by the last fetch
+template <class Alloc>
+void BasicFetcher<Alloc>::refreshNetworkStats() {
+    std::vector<Link> links;
+    if (!dumpLinks(links)) return;
 
-void Fetcher::fetchBatteryInfo() {
-    info_.batteries.clear();
-    const fs::path power_path = "/sys/class/power_supply";
-    if (!fs::exists(power_path)) return;
+    std::unordered_map<int, const Link*> by_index;
+    for (const Link& link : links)
+        by_index.emplace(link.ifindex, &link);
+    for (NetworkInterface& nic : info_.network_interfaces) {
+        if (auto it = by_index.find(nic.ifindex); it != by_index.end())
+            copyLinkStats(nic, *it->second);
+    }
+}
 
-    for (const auto& entry : fs::directory_iterator(power_path)) {
-        const fs::path type_path = entry.path() / "type";
-        if (!fs::exists(type_path)) continue;
-        
-        std::string type = readFirstLine(type_path);
-        if (type != "Battery") continue;
-        
-        Battery battery;
-        battery.name = entry.path().filename().string();
-        
-        // Capacity
-        const fs::path capacity_path = entry.path() / "capacity";
-        if (fs::exists(capacity_path)) {
-            std::string cap = readFirstLine(capacity_path);
-            if (!cap.empty()) battery.percentage = std::stoi(cap);
-        }
-        
-        // Status
-        const fs::path status_path = entry.path() / "status";
-        if (fs::exists(status_path)) {
-            battery.status = readFirstLine(status_path);
+// -------------------- BATTERY --------------------
+
+// Charge, status and voltage: the parts of a battery that move
+template <class Alloc>
+void BasicFetcher<Alloc>::readBatteryLevel(std::string_view uevent, Battery& battery) {
+    forEachUevent(uevent, [&](std::string_view key, std::string_view value) {
+        if (!key.starts_with("POWER_SUPPLY_")) return;
+        if (key == "POWER_SUPPLY_CAPACITY") {
+            if (auto percent = parse<int>(key, value))
+                battery.percentage = *percent;
+        } else if (key == "POWER_SUPPLY_STATUS") {
+            battery.status = value;
             battery.is_charging = (battery.status == "Charging");
             battery.ac_connected = (battery.status == "Charging" || battery.status == "Full");
+        } else if (key == "POWER_SUPPLY_VOLTAGE_NOW") {
+            if (auto uv = parse<int64_t>(key, value))
+                battery.voltage = *uv / 1e6;  // Convert µV to V
         }
-        
-        // Voltage
-        const fs::path voltage_path = entry.path() / "voltage_now";
-        if (fs::exists(voltage_path)) {
-            std::string volt = readFirstLine(voltage_path);
-            if (!volt.empty()) {
-                double volts = std::stod(volt);
-                battery.voltage = volts / 1e6;  // Convert µV to V
-            }
+    });
+}
+
+// Everything comes from one uevent read per supply
+template <class Alloc>
+void BasicFetcher<Alloc>::fetchBatteryInfo() {
+    info_.batteries.clear();
+    Dir power("/sys/class/power_supply");
+    if (!power) return;
+
+    power.forEach([&](std::string_view name) {
+        char buf[4096];
+        std::string_view uevent = power.file((std::string(name) + "/uevent").c_str(), buf, sizeof(buf));
+
+        bool is_battery = false;
+        bool typed = false;
+        double energy_wh = 0.0;
+        int charge_mah = 0;
+        forEachUevent(uevent, [&](std::string_view key, std::string_view value) {
+            if (key == "POWER_SUPPLY_TYPE") {
+                typed = true;
+                is_battery = (value == "Battery");
+            } else if (key == "POWER_SUPPLY_ENERGY_FULL")
+                energy_wh = parse<int64_t>(key, value).value_or(0) / 1e6;  // µWh to Wh
+            else if (key == "POWER_SUPPLY_CHARGE_FULL")
+                charge_mah = static_cast<int>(parse<int64_t>(key, value).value_or(0) / 1000);  // µAh to mAh
+        });
+        // Not every driver puts the type in uevent; the attribute always has it
+        if (!typed) {
+            char type[32];
+            is_battery = power.attr((std::string(name) + "/type").c_str(), type, sizeof(type)) == "Battery";
         }
+        if (!is_battery) return;
+        
+        Battery battery(info_.batteries.get_allocator());
+        battery.name = name;
+        readBatteryLevel(uevent, battery);
         
         // Capacity in mAh
-        const fs::path energy_full_path = entry.path() / "energy_full";
-        const fs::path charge_full_path = entry.path() / "charge_full";
-        if (fs::exists(energy_full_path)) {
-            std::string energy = readFirstLine(energy_full_path);
-            if (!energy.empty() && battery.voltage > 0) {
-                double energy_wh = std::stod(energy) / 1e6;  // µWh to Wh
+        if (energy_wh > 0) {
+            if (battery.voltage > 0)
                 battery.capacity_mah = static_cast<int>((energy_wh * 1000) / battery.voltage);
-            }
-        } else if (fs::exists(charge_full_path)) {
-            std::string charge = readFirstLine(charge_full_path);
-            if (!charge.empty()) {
-                battery.capacity_mah = std::stoi(charge) / 1000;  // µAh to mAh
-            }
+        } else {
+            battery.capacity_mah = charge_mah;
         }
         
-        info_.batteries.push_back(battery);
+        info_.batteries.push_back(std::move(battery));
+    });
+}
+
+// Re-reads the level of every battery found by the last fetch: one pread
+// of its uevent, kept open in the file cache
+template <class Alloc>
+void BasicFetcher<Alloc>::refreshBatteryLevels() {
+    char buf[4096];
+    for (Battery& battery : info_.batteries) {
+        std::string path = "/sys/class/power_supply/";
+        path.append(battery.name).append("/uevent");
+        ssize_t n = files_->read(path, buf, sizeof(buf));
+        if (n > 0)
+            readBatteryLevel(std::string_view(buf, n), battery);
     }
 }
 
 // -------------------- SHELL / TERMINAL / DE --------------------
 
-void Fetcher::fetchShellInfo() {
+template <class Alloc>
+void BasicFetcher<Alloc>::fetchShellInfo() {
     if (const char* s = getenv("SHELL"))
         info_.shell = fs::path(s).filename().string();
 }
 
-void Fetcher::fetchTerminalInfo() {
+template <class Alloc>
+void BasicFetcher<Alloc>::fetchTerminalInfo() {
     // Try multiple environment variables
     const char* env_vars[] = {"TERM_PROGRAM", "TERMINAL_EMULATOR", "TERM", nullptr};
     for (const char** var = env_vars; *var; ++var) {
@@ -497,7 +2236,8 @@ void Fetcher::fetchTerminalInfo() {
     }
 }
 
-void Fetcher::fetchDesktopEnvironment() {
+template <class Alloc>
+void BasicFetcher<Alloc>::fetchDesktopEnvironment() {
     // Try multiple environment variables
     const char* env_vars[] = {"XDG_CURRENT_DESKTOP", "DESKTOP_SESSION", "GDMSESSION", nullptr};
     for (const char** var = env_vars; *var; ++var) {
@@ -510,13 +2250,15 @@ void Fetcher::fetchDesktopEnvironment() {
 
 // -------------------- UPTIME / LOCALE --------------------
 
-void Fetcher::fetchUptimeInfo() {
+template <class Alloc>
+void BasicFetcher<Alloc>::fetchUptimeInfo() {
     // Read from /proc/uptime for more precision
-    std::ifstream uptime_file("/proc/uptime");
-    if (uptime_file) {
-        double uptime_seconds;
-        uptime_file >> uptime_seconds;
-        info_.uptime_seconds = static_cast<long>(uptime_seconds);
+    // "350735.47 234388.90": seconds up, then seconds idle summed over CPUs
+    char buf[64];
+    ssize_t n = files_->read("/proc/uptime", buf, sizeof(buf));
+    std::string_view text(buf, n > 0 ? n : 0);
+    if (auto up = parse<double>("uptime", text.substr(0, text.find(' ')))) {
+        info_.uptime_seconds = static_cast<long>(*up);
     } else {
         // Fallback to sysinfo
         struct sysinfo si;
@@ -525,7 +2267,8 @@ void Fetcher::fetchUptimeInfo() {
     }
 }
 
-void Fetcher::fetchLocaleInfo() {
+template <class Alloc>
+void BasicFetcher<Alloc>::fetchLocaleInfo() {
     // Try multiple locale variables
     const char* env_vars[] = {"LC_ALL", "LC_MESSAGES", "LANG", nullptr};
     for (const char** var = env_vars; *var; ++var) {
@@ -602,4 +2345,13 @@ double bytesToMiB(uint64_t bytes) {
     return static_cast<double>(bytes) / (1024.0 * 1024.0);
 }
 
-} // namespace SystemInfo
\ No newline at end of file
+// -------------------- Instantiations --------------------
+
+template struct BasicCPUMetrics<std::allocator<char>>;
+template struct BasicCPUMetrics<std::pmr::polymorphic_allocator<>>;
+template struct BasicInfo<std::allocator<char>>;
+template struct BasicInfo<std::pmr::polymorphic_allocator<>>;
+template class BasicFetcher<std::allocator<char>>;
+template class BasicFetcher<std::pmr::polymorphic_allocator<>>;
+
+} // namespace SystemInfo
@@ -1,26 +1,68 @@
 #pragma once
+#include "intern.hpp"
 #include <string>
+#include <string_view>
 #include <vector>
+#include <memory>
+#include <memory_resource>
+#include <span>
+#include <future>
+#include <mutex>
+#include <optional>
 #include <cstdint>
+#include <type_traits>
+
+class ThreadPool;
 
 namespace SystemInfo {
 
+class Arena;
+
+// Info and its parts come in two flavours that differ only in where their
+// strings and lists live. Info, Disk, GPU and the rest hold std::string and
+// std::vector on the heap. ArenaInfo and its parts (ArenaInfo::Disk, ...)
+// hold the std::pmr types, so an ArenaFetcher can build all of it in one
+// Arena. Both are the templates below; a pmr part takes its resource as an
+// allocator, so a list of them hands its own resource down to every
+// element it holds.
+
+template <class Alloc>
+using BasicString = std::basic_string<char, std::char_traits<char>,
+                                      typename std::allocator_traits<Alloc>::template rebind_alloc<char>>;
+
+template <class T, class Alloc>
+using BasicList = std::vector<T, typename std::allocator_traits<Alloc>::template rebind_alloc<T>>;
+
 // Display information
-struct Display {
-    std::string name;
+template <class Alloc>
+struct BasicDisplay {
+    using allocator_type = Alloc;
+    BasicDisplay() = default;
+    explicit BasicDisplay(const allocator_type& a) : name(a), output_name(a), current_mode(a) {}
+    BasicDisplay(const BasicDisplay& other, const allocator_type& a) : BasicDisplay(a) { *this = other; }
+    BasicDisplay(BasicDisplay&& other, const allocator_type& a) : BasicDisplay(a) { *this = std::move(other); }
+
+    BasicString<Alloc> name;
     int width = 0;
     int height = 0;
     int refresh_rate = 0;
     double size_inches = 0.0;
     bool is_builtin = false;
-    std::string output_name;
-    std::string current_mode;  // Added: current resolution/refresh rate
+    BasicString<Alloc> output_name;
+    BasicString<Alloc> current_mode;  // Added: current resolution/refresh rate
 };
 
 // Disk information
-struct Disk {
-    std::string mount_point;
-    std::string filesystem;
+template <class Alloc>
+struct BasicDisk {
+    using allocator_type = Alloc;
+    BasicDisk() = default;
+    explicit BasicDisk(const allocator_type& a) : mount_point(a) {}
+    BasicDisk(const BasicDisk& other, const allocator_type& a) : BasicDisk(a) { *this = other; }
+    BasicDisk(BasicDisk&& other, const allocator_type& a) : BasicDisk(a) { *this = std::move(other); }
+
+    BasicString<Alloc> mount_point;
+    Atom filesystem;
     uint64_t total_bytes = 0;
     uint64_t used_bytes = 0;
     uint64_t available_bytes = 0;
@@ -29,23 +71,52 @@ struct Disk {
 };
 
 // Network interface information
-struct NetworkInterface {
-    std::string name;
-    std::string ipv4;
-    std::string ipv6;
-    std::string mac;
-    std::string subnet_mask;
+template <class Alloc>
+struct BasicNetworkInterface {
+    using allocator_type = Alloc;
+    BasicNetworkInterface() = default;
+    explicit BasicNetworkInterface(const allocator_type& a)
+        : name(a), ipv4(a), ipv6(a), mac(a), subnet_mask(a), ipv4_addresses(a) {}
+    BasicNetworkInterface(const BasicNetworkInterface& other, const allocator_type& a)
+        : BasicNetworkInterface(a) { *this = other; }
+    BasicNetworkInterface(BasicNetworkInterface&& other, const allocator_type& a)
+        : BasicNetworkInterface(a) { *this = std::move(other); }
+
+    BasicString<Alloc> name;
+    BasicString<Alloc> ipv4;
+    BasicString<Alloc> ipv6;
+    BasicString<Alloc> mac;
+    BasicString<Alloc> subnet_mask;
     bool is_up = false;
     bool is_wireless = false;
-    std::string operstate;  // Added: from /sys/class/net/*/operstate
-    std::vector<std::string> ipv4_addresses;  // Added: multiple IPs possible
+    Atom operstate;  // Added: from /sys/class/net/*/operstate
+    BasicList<BasicString<Alloc>, Alloc> ipv4_addresses;  // Added: multiple IPs possible
+    int ifindex = 0;
+    uint32_t mtu = 0;
+
+    // Traffic since the link came up
+    uint64_t rx_bytes = 0;
+    uint64_t tx_bytes = 0;
+    uint64_t rx_packets = 0;
+    uint64_t tx_packets = 0;
+    uint64_t rx_errors = 0;
+    uint64_t tx_errors = 0;
+    uint64_t rx_dropped = 0;
+    uint64_t tx_dropped = 0;
 };
 
 // Battery information
-struct Battery {
-    std::string name;
+template <class Alloc>
+struct BasicBattery {
+    using allocator_type = Alloc;
+    BasicBattery() = default;
+    explicit BasicBattery(const allocator_type& a) : name(a) {}
+    BasicBattery(const BasicBattery& other, const allocator_type& a) : BasicBattery(a) { *this = other; }
+    BasicBattery(BasicBattery&& other, const allocator_type& a) : BasicBattery(a) { *this = std::move(other); }
+
+    BasicString<Alloc> name;
     int percentage = -1;
-    std::string status;        // Charging, Discharging, Full, AC Connected
+    Atom status;        // Charging, Discharging, Full, AC Connected
     bool is_charging = false;
     bool ac_connected = false;
     int time_remaining_mins = -1;   // -1 if unknown
@@ -72,24 +143,75 @@ struct Swap {
     int usage_percent = 0;
 };
 
+// Per-CPU metrics as a struct of arrays: element i of every array is CPU
+// i. All arrays have one element per possible id up to the highest in
+// /sys/devices/system/cpu/present, so ids missing from it are offline.
+// Unreadable values are NaN in the float arrays and -1 in the id arrays.
+template <class Alloc>
+struct BasicCPUMetrics {
+    using allocator_type = Alloc;
+    BasicCPUMetrics() = default;
+    explicit BasicCPUMetrics(const allocator_type& a)
+        : freq_ghz(a), temp_c(a), utilization(a), online(a), package(a), core(a), node(a) {}
+
+    // Sampled
+    BasicList<float, Alloc> freq_ghz;
+    BasicList<float, Alloc> temp_c;       // Of the core, else of its package
+    BasicList<float, Alloc> utilization;  // Busy share, 0-1, since the last sample (since boot at first)
+    BasicList<uint8_t, Alloc> online;
+
+    // Topology
+    BasicList<int32_t, Alloc> package;
+    BasicList<int32_t, Alloc> core;
+    BasicList<int32_t, Alloc> node;       // NUMA
+
+    size_t size() const { return online.size(); }
+    void resize(size_t n);                // New elements are unknown and offline
+};
+
+// One pass over a per-CPU metric, skipping NaN. All NaN when no value is
+// left.
+struct MetricSummary {
+    float min = 0.0f;
+    float max = 0.0f;
+    float avg = 0.0f;
+    size_t count = 0;  // Values that were not NaN
+};
+MetricSummary summarize(std::span<const float> values);
+
+// Counts of the non-NaN values in `buckets` equal bins over [lo, hi).
+// Values outside the range land in the first or last bin.
+std::vector<uint32_t> histogram(std::span<const float> values, float lo, float hi, size_t buckets);
+
 // CPU information
-struct CPU {
-    std::string model;
-    std::string vendor;
+template <class Alloc>
+struct BasicCPU {
+    using allocator_type = Alloc;
+    BasicCPU() = default;
+    explicit BasicCPU(const allocator_type& a) : model(a), architecture(a), per_cpu(a) {}
+
+    BasicString<Alloc> model;
+    Atom vendor;
     int core_count = 0;
     int thread_count = 0;
     double max_freq_ghz = 0.0;
     double current_freq_ghz = 0.0;
-    std::string architecture;
-    std::vector<double> core_freqs;
-    std::vector<int> core_temps;    // In Celsius
+    BasicString<Alloc> architecture;
+    BasicCPUMetrics<Alloc> per_cpu;
 };
 
 // GPU information
-struct GPU {
-    std::string model;
-    std::string vendor;
-    std::string driver;
+template <class Alloc>
+struct BasicGPU {
+    using allocator_type = Alloc;
+    BasicGPU() = default;
+    explicit BasicGPU(const allocator_type& a) : model(a), driver(a) {}
+    BasicGPU(const BasicGPU& other, const allocator_type& a) : BasicGPU(a) { *this = other; }
+    BasicGPU(BasicGPU&& other, const allocator_type& a) : BasicGPU(a) { *this = std::move(other); }
+
+    BasicString<Alloc> model;
+    Atom vendor;
+    BasicString<Alloc> driver;
     double freq_ghz = 0.0;
     int memory_mb = 0;
     bool is_integrated = false;
@@ -97,78 +219,134 @@ struct GPU {
 };
 
 // Desktop Environment information
-struct DesktopEnvironment {
-    std::string name;
-    std::string version;
-    std::string wm_name;
-    std::string wm_protocol;    // X11, Wayland, etc.
-    std::string theme;
-    std::string wm_theme;
-    std::string icon_theme;
-    std::string cursor_theme;
+template <class Alloc>
+struct BasicDesktopEnvironment {
+    using allocator_type = Alloc;
+    BasicDesktopEnvironment() = default;
+    explicit BasicDesktopEnvironment(const allocator_type& a)
+        : name(a), version(a), wm_name(a), wm_protocol(a), theme(a), wm_theme(a),
+          icon_theme(a), cursor_theme(a), font_name(a) {}
+
+    BasicString<Alloc> name;
+    BasicString<Alloc> version;
+    BasicString<Alloc> wm_name;
+    BasicString<Alloc> wm_protocol;    // X11, Wayland, etc.
+    BasicString<Alloc> theme;
+    BasicString<Alloc> wm_theme;
+    BasicString<Alloc> icon_theme;
+    BasicString<Alloc> cursor_theme;
     int cursor_size = 0;
-    std::string font_name;
+    BasicString<Alloc> font_name;
     int font_size = 0;
 };
 
 // Package information - NOTE: We won't fetch this without subprocesses
-struct PackageInfo {
-    std::string manager_name;
+template <class Alloc>
+struct BasicPackageInfo {
+    using allocator_type = Alloc;
+    BasicPackageInfo() = default;
+    explicit BasicPackageInfo(const allocator_type& a) : manager_name(a) {}
+    BasicPackageInfo(const BasicPackageInfo& other, const allocator_type& a) : BasicPackageInfo(a) { *this = other; }
+    BasicPackageInfo(BasicPackageInfo&& other, const allocator_type& a) : BasicPackageInfo(a) { *this = std::move(other); }
+
+    BasicString<Alloc> manager_name;
     int count = 0;
 };
 
 // Main system information structure
-struct Info {
+template <class Alloc>
+struct BasicInfo {
+    using allocator_type = Alloc;
+    using String = BasicString<Alloc>;
+    template <class T>
+    using List = BasicList<T, Alloc>;
+
+    using Display = BasicDisplay<Alloc>;
+    using Disk = BasicDisk<Alloc>;
+    using NetworkInterface = BasicNetworkInterface<Alloc>;
+    using Battery = BasicBattery<Alloc>;
+    using CPUMetrics = BasicCPUMetrics<Alloc>;
+    using CPU = BasicCPU<Alloc>;
+    using GPU = BasicGPU<Alloc>;
+    using DesktopEnvironment = BasicDesktopEnvironment<Alloc>;
+    using PackageInfo = BasicPackageInfo<Alloc>;
+
+    BasicInfo() = default;
+    explicit BasicInfo(const allocator_type& a);
+
     // Basic info
-    std::string username;
-    std::string hostname;
-    std::string os_name;
-    std::string os_version;
-    std::string os_codename;
-    std::string os_id;
-    std::string kernel;
-    std::string kernel_version;
-    std::string architecture;
+    String username;
+    String hostname;
+    String os_name;
+    String os_version;
+    String os_codename;
+    String os_id;
+    String kernel;
+    String kernel_version;
+    String architecture;
     
     // Hardware info
-    std::string model;
-    std::string manufacturer;
-    std::string bios_version;
-    std::string board_name;
-    std::string chassis_type;
+    String model;
+    String manufacturer;
+    String bios_version;
+    String board_name;
+    String chassis_type;
     
     // Shell info
-    std::string shell;
-    std::string shell_version;
-    std::string terminal;
-    std::string terminal_version;
+    String shell;
+    String shell_version;
+    String terminal;
+    String terminal_version;
     
     // Time info
     uint64_t uptime_seconds = 0;
-    std::string boot_time;
-    std::string current_time;
+    String boot_time;
+    String current_time;
     
     // Locale info
-    std::string locale;
-    std::string timezone;
+    String locale;
+    String timezone;
     
     // Complex structures
     CPU cpu;
-    std::vector<GPU> gpus;
+    List<GPU> gpus;
     Memory memory;
     Swap swap;
-    std::vector<Display> displays;
-    std::vector<Disk> disks;
-    std::vector<NetworkInterface> network_interfaces;
-    std::vector<Battery> batteries;
+    List<Display> displays;
+    List<Disk> disks;
+    List<NetworkInterface> network_interfaces;
+    List<Battery> batteries;
     DesktopEnvironment de;
-    std::vector<PackageInfo> packages;
+    List<PackageInfo> packages;
     
     // Totals
     int total_packages = 0;
-    std::string package_managers;  // Formatted string
+    String package_managers;  // Formatted string
+
+    // Collectors abandoned because Flags::deadline_us ran out, and mounts
+    // whose statvfs did not answer in time, as "disk <mount point>"
+    List<String> unavailable;
+
+    // Values that were there but were not numbers, as `field: "text"`.
+    // Each such field keeps its default.
+    List<String> parse_errors;
 };
 
+// On the heap
+using Info = BasicInfo<std::allocator<char>>;
+using Display = Info::Display;
+using Disk = Info::Disk;
+using NetworkInterface = Info::NetworkInterface;
+using Battery = Info::Battery;
+using CPUMetrics = Info::CPUMetrics;
+using CPU = Info::CPU;
+using GPU = Info::GPU;
+using DesktopEnvironment = Info::DesktopEnvironment;
+using PackageInfo = Info::PackageInfo;
+
+// In a std::pmr memory resource, the heap unless given one
+using ArenaInfo = BasicInfo<std::pmr::polymorphic_allocator<>>;
+
 // Configuration flags
 struct Flags {
     bool os = true;
@@ -187,19 +365,180 @@ struct Flags {
     bool de = true;
     bool packages = true;
     bool uptime = true;
+
+    // Run independent collectors concurrently on the fetcher's thread pool
+    bool parallel = false;
+
+    // Latency budget for fetchInfo in microseconds, 0 for none. Collectors
+    // still running when it expires are abandoned and listed in
+    // Info::unavailable. Implies a parallel fetch.
+    uint64_t deadline_us = 0;
+
+    // Measure every collector, see Fetcher::getTimings()
+    bool timings = false;
+
+    // Count every collector's file operations, see Fetcher::getIOStats()
+    bool io_stats = false;
+
+    // Take OS, kernel, host, CPU identity and GPUs from the boot-keyed
+    // cache file instead of re-reading them; fetchInfo writes it on a miss
+    bool static_cache = false;
 };
 
-// Main fetcher class
-class Fetcher {
+// Cost of one collector or any other step measured with a Stopwatch
+struct Timing {
+    std::string name;
+    uint64_t wall_ns = 0;
+    uint64_t cpu_ns = 0;        // CPU time of the thread that ran it
+    uint64_t rw_calls = 0;      // read/write-class syscalls (syscr + syscw); opens, stats and
+                                // socket calls are not counted, see IOStats for those
+};
+
+// File operations of one collector. Counted in the backend's own wrappers
+// around the syscalls, so they cover exactly what nacfetch asked for.
+struct IOStats {
+    std::string name;
+    uint64_t opens = 0;         // Files and directories opened
+    uint64_t reads = 0;         // read/pread calls, batched ones included
+    uint64_t stats = 0;         // Metadata probes: faccessat, statvfs
+    uint64_t bytes = 0;         // Bytes those reads returned
+    uint64_t dirents = 0;       // Directory entries scanned
+};
+
+// Measures wall time, thread CPU time and read/write calls on the calling
+// thread. The calls come from /proc/thread-self/io and read 0 on kernels
+// built without task I/O accounting.
+class Stopwatch {
 public:
-    Fetcher();
-    ~Fetcher() = default;
+    void start();
+    Timing stop(std::string name) const;
+
+private:
+    uint64_t wall_ns_ = 0;
+    uint64_t cpu_ns_ = 0;
+    uint64_t rw_calls_ = 0;
+};
+
+// Handles returned by Fetcher::fetchAsync, one per section. Each becomes
+// ready as soon as the collector behind it finishes (immediately, with an
+// empty value, if its flag is off). `all` becomes ready once every
+// collector has finished; only then is getInfo() safe to read.
+template <class Alloc>
+struct BasicAsyncInfo {
+    using Info = BasicInfo<Alloc>;
+
+    std::future<typename Info::CPU> cpu;
+    std::future<typename Info::template List<typename Info::GPU>> gpus;
+    std::future<Memory> memory;
+    std::future<Swap> swap;
+    std::future<typename Info::template List<typename Info::Disk>> disks;
+    std::future<typename Info::template List<typename Info::Display>> displays;
+    std::future<typename Info::template List<typename Info::NetworkInterface>> network_interfaces;
+    std::future<typename Info::template List<typename Info::Battery>> batteries;
+    std::future<typename Info::DesktopEnvironment> de;
+    std::future<uint64_t> uptime_seconds;
+    std::future<void> all;
+};
+
+using AsyncInfo = BasicAsyncInfo<std::allocator<char>>;
+
+struct ReadRequest;  // io_batch.hpp
+
+// Main fetcher class. Fetcher fills an Info, ArenaFetcher an ArenaInfo;
+// both are defined in sysinfo.cpp, which instantiates them.
+template <class Alloc>
+class BasicFetcher {
+public:
+    using Info = BasicInfo<Alloc>;
+    using AsyncInfo = BasicAsyncInfo<Alloc>;
+
+    BasicFetcher();
+    explicit BasicFetcher(Info info);  // Start from known values, e.g. a daemon's
+
+    // Keeps every string and list of the Info in `arena`, which must
+    // outlive the Fetcher. fetchInfo() and fetchAsync() reset the arena
+    // and build the Info afresh in it; refresh() updates it in place, in
+    // the room its values already have. parse_errors and unavailable are
+    // filled anew every time, so they go to a small arena of the
+    // Fetcher's own instead, reset along with them.
+    explicit BasicFetcher(Arena& arena) requires std::is_same_v<Alloc, std::pmr::polymorphic_allocator<>>;
+
+    // Waits for collectors a fetchAsync still has running
+    ~BasicFetcher();
     
     void fetchInfo(const Flags& flags = Flags());
     const Info& getInfo() const;
+
+    // Re-reads only what moves between samples (memory, swap, uptime, CPU
+    // clocks, battery levels, disk usage, network counters) into the Info
+    // of the last fetch. Batteries, mounts and links are not looked for
+    // again.
+    void refresh(const Flags& flags = Flags());
+
+    // One entry per collector run by the last fetch with Flags::timings,
+    // in table order. Abandoned collectors are left out.
+    std::vector<Timing> getTimings() const;
+
+    // One entry per collector run by the last fetch with Flags::io_stats,
+    // in table order. Abandoned collectors are left out.
+    std::vector<IOStats> getIOStats() const;
+
+    // Starts every collector on the thread pool and returns immediately.
+    // Do not start another fetch on this Fetcher before `all` is ready. Its
+    // collectors share the pool with every other fetch on this Fetcher, and
+    // a parallel fetch waits for the pool to drain, so it would block on
+    // them too.
+    AsyncInfo fetchAsync(const Flags& flags = Flags());
     
 private:
+    using String = typename Info::String;
+    template <class T>
+    using List = typename Info::template List<T>;
+    using Display = typename Info::Display;
+    using Disk = typename Info::Disk;
+    using NetworkInterface = typename Info::NetworkInterface;
+    using Battery = typename Info::Battery;
+    using CPUMetrics = typename Info::CPUMetrics;
+    using CPU = typename Info::CPU;
+    using GPU = typename Info::GPU;
+    using DesktopEnvironment = typename Info::DesktopEnvironment;
+
+    struct Collector;
+    struct Schedule;
+    struct FileCache;
+    struct CPUSamples;
+    struct StuckMounts;
+    struct StatJobs;
+
     Info info_;
+    std::vector<Timing> timings_;       // Indexed like the collector table
+    std::vector<IOStats> io_stats_;     // Likewise
+    std::shared_ptr<FileCache> files_;  // Sampled files kept open for pread
+    std::shared_ptr<StuckMounts> stuck_mounts_;  // Mounts whose statvfs never returned
+    std::unique_ptr<ThreadPool> pool_;  // Created on first parallel fetch
+    std::vector<std::shared_ptr<Schedule>> abandoned_;  // Deadline fetches with collectors still running
+    std::mutex errors_mutex_;           // Guards info_.parse_errors and info_.unavailable
+    Arena* arena_ = nullptr;            // Where info_ lives, if not the heap
+    std::unique_ptr<Arena> reports_;    // Where its parse_errors and unavailable live then
+    std::unique_ptr<CPUSamples> cpu_samples_;  // Kept between refreshes by the cpufreq collector
+
+    void resetArena();
+    void clearReports();
+    void collect(size_t index, bool timed, bool counted);
+    void run(const Flags& flags, uint32_t enabled);
+    std::string_view readCachedAttr(const std::string& path, char* buf, size_t size);
+    void readCachedBatch(std::span<ReadRequest> requests);
+    template <class T>
+    std::optional<T> parse(std::string_view field, std::string_view text);
+    void parseError(std::string_view field, std::string_view text);
+    void fetchSequential(const Flags& flags, uint32_t enabled);
+    void fetchWithDeadline(const Flags& flags, uint32_t wanted);
+    static uint32_t enabledCollectors(const Flags& flags);
+    uint32_t restoreStaticCache(const Flags& flags);
+    std::shared_ptr<Schedule> schedule(const Flags& flags, uint32_t enabled);
+    ThreadPool& pool();
+    void dispatch(const std::shared_ptr<Schedule>& s, size_t index);
+    void runCollector(const std::shared_ptr<Schedule>& s, size_t index);
     
     // Individual fetch methods - removed fetchPackageInfo since we can't get it
     void fetchBasicInfo();
@@ -209,9 +548,13 @@ private:
     void fetchShellInfo();
     void fetchTerminalInfo();
     void fetchCPUInfo();
+    void fetchCPUFrequencies();
+    size_t presentCPUs();
+    void sampleCPUClocks();
+    void sampleCPULoad();
+    void sampleCPUTemperatures();
     void fetchGPUInfo();
     void fetchMemoryInfo();
-    void fetchSwapInfo();
     void fetchDiskInfo();
     void fetchDisplayInfo();
     void fetchNetworkInfo();
@@ -219,8 +562,19 @@ private:
     void fetchDesktopEnvironment();
     void fetchUptimeInfo();
     void fetchLocaleInfo();
+    void readBatteryLevel(std::string_view uevent, Battery& battery);
+    void refreshBatteryLevels();
+    void refreshDiskUsage();
+    std::vector<bool> readDiskUsage(List<Disk>& disks);
+    void refreshNetworkStats();
 };
 
+using Fetcher = BasicFetcher<std::allocator<char>>;
+using ArenaFetcher = BasicFetcher<std::pmr::polymorphic_allocator<>>;
+
+extern template class BasicFetcher<std::allocator<char>>;
+extern template class BasicFetcher<std::pmr::polymorphic_allocator<>>;
+
 // Utility functions
 std::string formatBytes(uint64_t bytes);
 std::string formatUptime(uint64_t seconds);
@@ -2,6 +2,10 @@
     #include "sysinfo.win.hpp"
 #else
     #include "sysinfo.hpp"
+    #include "arena.hpp"
+    #include "snapshot.hpp"
+    #include "json.hpp"
+    #include "wire.hpp"
 #endif
 #include <iostream>
 #include <iomanip>
@@ -306,6 +310,238 @@ int main() {
         cout << "No batteries detected (desktop system?)\n";
     }
     
+    cout << "\n";
+
+#if !defined(_WIN32) && !defined(_WIN64)
+    // Test 10: Parallel fetch
+    cout << "Test 10: Parallel fetch\n";
+    cout << "-----------------------\n";
+
+    Flags par_flags;
+    par_flags.parallel = true;
+
+    Fetcher fetcher10;
+    fetcher10.fetchInfo(par_flags);
+    const Info& info10 = fetcher10.getInfo();
+
+    cout << "Hostname: " << info10.hostname << "\n";
+    cout << "CPU architecture: " << info10.cpu.architecture << "\n";
+    cout << "Matches sequential fetch: "
+         << (info10.hostname == info.hostname &&
+             info10.os_name == info.os_name &&
+             info10.cpu.model == info.cpu.model &&
+             info10.cpu.architecture == info.architecture &&
+             info10.gpus.size() == info.gpus.size() &&
+             info10.disks.size() == info.disks.size() &&
+             info10.network_interfaces.size() == info.network_interfaces.size()
+                 ? "Yes" : "No") << "\n";
+
+    cout << "\n";
+
+    // Test 11: Asynchronous per-section fetch
+    cout << "Test 11: Asynchronous fetch\n";
+    cout << "---------------------------\n";
+
+    Flags async_flags;
+    async_flags.display = false;
+
+    Fetcher fetcher11;
+    AsyncInfo pending = fetcher11.fetchAsync(async_flags);
+
+    Memory mem11 = pending.memory.get();
+    cout << "Memory (ready first): " << formatMemory(mem11.total_bytes) << "\n";
+    cout << "Uptime: " << formatUptime(pending.uptime_seconds.get()) << "\n";
+    cout << "GPUs: " << pending.gpus.get().size() << "\n";
+    cout << "Displays (disabled): " << pending.displays.get().size() << "\n";
+
+    pending.all.wait();
+    cout << "Hostname after all: " << fetcher11.getInfo().hostname << "\n";
+
+    cout << "\n";
+
+    // Test 12: Deadline-bounded fetch
+    cout << "Test 12: Deadline-bounded fetch\n";
+    cout << "-------------------------------\n";
+
+    Flags tight_flags;
+    tight_flags.deadline_us = 1;
+
+    Fetcher fetcher12;
+    fetcher12.fetchInfo(tight_flags);
+    cout << "Abandoned with a 1 us budget: " << fetcher12.getInfo().unavailable.size() << "\n";
+
+    Flags loose_flags;
+    loose_flags.deadline_us = 5000000;
+
+    fetcher12.fetchInfo(loose_flags);
+    const Info& info12 = fetcher12.getInfo();
+    cout << "Abandoned with a 5 s budget: " << info12.unavailable.size() << "\n";
+    cout << "Hostname: " << info12.hostname << "\n";
+
+    cout << "\n";
+
+    // Test 13: Static facts served from the per-boot cache
+    cout << "Test 13: Static cache\n";
+    cout << "---------------------\n";
+
+    Flags cache_flags;
+    cache_flags.static_cache = true;
+
+    Fetcher fetcher13;
+    fetcher13.fetchInfo(cache_flags);  // Cold: collects and writes the cache
+    fetcher13.fetchInfo(cache_flags);  // Warm: reads it back
+    const Info& info13 = fetcher13.getInfo();
+
+    cout << "CPU: " << info13.cpu.model << " (" << info13.cpu.thread_count << " threads)\n";
+    cout << "Matches uncached fetch: "
+         << (info13.os_name == info.os_name &&
+             info13.kernel == info.kernel &&
+             info13.model == info.model &&
+             info13.cpu.model == info.cpu.model &&
+             info13.cpu.thread_count == info.cpu.thread_count &&
+             info13.cpu.architecture == info.architecture &&
+             info13.gpus.size() == info.gpus.size()
+                 ? "Yes" : "No") << "\n";
+
+    cout << "\n";
+
+    // Test 14: Refreshing volatile fields only
+    cout << "Test 14: Refresh\n";
+    cout << "----------------\n";
+
+    Fetcher fetcher14;
+    fetcher14.fetchInfo();
+    uint64_t uptime_before = fetcher14.getInfo().uptime_seconds;
+    fetcher14.refresh();
+    const Info& info14 = fetcher14.getInfo();
+
+    cout << "Uptime: " << formatUptime(uptime_before) << " -> "
+         << formatUptime(info14.uptime_seconds) << "\n";
+    cout << "Memory used: " << formatMemory(info14.memory.used_bytes) << "\n";
+    for (const auto& net : info14.network_interfaces) {
+        cout << "Traffic " << net.name << ": " << formatBytes(net.rx_bytes) << " in, "
+             << formatBytes(net.tx_bytes) << " out (MTU " << net.mtu << ")\n";
+    }
+    cout << "Hardware kept: "
+         << (info14.cpu.model == info.cpu.model &&
+             info14.gpus.size() == info.gpus.size() &&
+             info14.disks.size() == info.disks.size() &&
+             info14.network_interfaces.size() == info.network_interfaces.size()
+                 ? "Yes" : "No") << "\n";
+
+    cout << "\n";
+
+    // Test 15: File I/O accounting
+    cout << "Test 15: I/O Stats\n";
+    cout << "------------------\n";
+
+    Flags flags15;
+    flags15.io_stats = true;
+    Fetcher fetcher15;
+    fetcher15.fetchInfo(flags15);
+
+    for (const auto& s : fetcher15.getIOStats()) {
+        if (s.opens == 0 && s.dirents == 0) continue;
+        cout << s.name << ": " << s.opens << " opens, " << s.reads << " reads, "
+             << s.stats << " stats, " << s.bytes << " bytes, "
+             << s.dirents << " dirents\n";
+    }
+    cout << "\n";
+
+    // Test 16: Malformed kernel values
+    cout << "Test 16: Parse errors\n";
+    cout << "---------------------\n";
+
+    const auto& errors16 = fetcher15.getInfo().parse_errors;
+    cout << "Values that were not numbers: " << errors16.size() << "\n";
+    for (const auto& e : errors16)
+        cout << "  " << e << "\n";
+    cout << "\n";
+
+    // Test 17: Info kept in an arena, reused across fetches
+    cout << "Test 17: Arena\n";
+    cout << "--------------\n";
+
+    Arena arena17(1024);
+    ArenaFetcher fetcher17(arena17);
+    fetcher17.fetchInfo();
+    cout << "First fetch: " << arena17.used() << " bytes, "
+         << arena17.blocks() << " blocks\n";
+    fetcher17.fetchInfo();
+    cout << "Second fetch: " << arena17.used() << " of " << arena17.capacity() << " bytes, "
+         << arena17.blocks() << " block\n";
+    for (int i = 0; i < 20; i++)
+        fetcher17.refresh();
+    cout << "After 20 refreshes: " << arena17.used() << " of " << arena17.capacity() << " bytes, "
+         << arena17.blocks() << " block\n";
+    cout << "Hostname: " << fetcher17.getInfo().hostname << "\n";
+    cout << "\n";
+
+    // Test 18: Per-CPU metrics, two samples apart
+    cout << "Test 18: Per-CPU metrics\n";
+    cout << "------------------------\n";
+
+    Fetcher fetcher18;
+    fetcher18.fetchInfo();
+    fetcher18.refresh();
+    const CPUMetrics& cpus18 = fetcher18.getInfo().cpu.per_cpu;
+    cout << "CPUs: " << cpus18.size() << "\n";
+    for (size_t i = 0; i < cpus18.size() && i < 4; i++) {
+        cout << "  cpu" << i << ": " << (cpus18.online[i] ? "online" : "offline")
+             << ", package " << cpus18.package[i] << ", core " << cpus18.core[i]
+             << ", node " << cpus18.node[i] << ", " << cpus18.freq_ghz[i] << " GHz, "
+             << cpus18.temp_c[i] << " C, " << cpus18.utilization[i] * 100 << "% busy\n";
+    }
+    MetricSummary load18 = summarize(cpus18.utilization);
+    cout << "Load: min " << load18.min << ", avg " << load18.avg << ", max " << load18.max
+         << " over " << load18.count << " CPUs\n";
+    cout << "Load histogram (10% bins):";
+    for (uint32_t n : histogram(cpus18.utilization, 0.0f, 1.0f, 10))
+        cout << " " << n;
+    cout << "\n";
+    cout << "\n";
+
+    // Test 19: Binary snapshot, read in place and back into an Info
+    cout << "Test 19: Snapshot\n";
+    cout << "-----------------\n";
+
+    namespace field = snapshot::field;
+    string blob19;
+    snapshot::write(info, blob19);
+    snapshot::View view19(blob19);
+    snapshot::Record root19 = view19.root();
+    cout << "Size: " << blob19.size() << " bytes, version " << view19.version() << "\n";
+    cout << "Hostname: " << root19.str(field::info::hostname) << "\n";
+    cout << "CPU: " << root19.record(field::info::cpu).str(field::cpu::model) << "\n";
+    snapshot::List disks19 = root19.list(field::info::disks);
+    for (size_t i = 0; i < disks19.size(); i++) {
+        snapshot::Record disk = disks19.record(i);
+        cout << "Disk: " << disk.str(field::disk::mount_point) << " ("
+             << disk.str(field::disk::filesystem) << ", " << disk.i64(field::disk::usage_percent) << "%)\n";
+    }
+
+    Info copy19;
+    bool read19 = snapshot::read(blob19, copy19);
+    wire::Writer before19, after19;
+    wire::visit(before19, info);
+    wire::visit(after19, copy19);
+    cout << "Read back: " << (read19 && before19.out == after19.out ? "identical" : "different") << "\n";
+    cout << "\n";
+
+    // Test 20: JSON, streamed in buffer-sized chunks
+    cout << "Test 20: JSON\n";
+    cout << "-------------\n";
+
+    string json20;
+    size_t chunks20 = 0;
+    writeJson(info, [&](string_view chunk) {
+        json20 += chunk;
+        chunks20++;
+    });
+    cout << "Size: " << json20.size() << " bytes in " << chunks20 << " chunks\n";
+    cout << "Start: " << json20.substr(0, 60) << "...\n";
+#endif
+
     cout << "\n=== All Tests Complete ===\n";
     
     return 0;
@@ -1,87 +1,341 @@
 #pragma once
 #include <vector>
 #include <thread>
-#include <queue>
-#include <functional>
-#include <mutex>
-#include <condition_variable>
+#include <deque>
+#include <memory>
 #include <atomic>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
 
+// Move-only callable. Captures up to InlineSize bytes live inside the task
+// itself, so scheduling a small lambda never touches the heap.
+class Task
+{
+public:
+    static constexpr size_t InlineSize = 48;
+
+    Task() = default;
+
+    template <class F, class = std::enable_if_t<!std::is_same_v<std::decay_t<F>, Task>>>
+    Task(F &&f)
+    {
+        using Fn = std::decay_t<F>;
+        if constexpr (sizeof(Fn) <= InlineSize && alignof(Fn) <= alignof(std::max_align_t) &&
+                      std::is_nothrow_move_constructible_v<Fn>)
+        {
+            ::new (storage) Fn(std::forward<F>(f));
+            ops = &inlineOps<Fn>;
+        }
+        else
+        {
+            ::new (storage) Fn *(new Fn(std::forward<F>(f)));
+            ops = &heapOps<Fn>;
+        }
+    }
+
+    Task(Task &&other) noexcept : ops(other.ops)
+    {
+        if (ops)
+            ops->move(storage, other.storage);
+        other.ops = nullptr;
+    }
+
+    Task &operator=(Task &&other) noexcept
+    {
+        if (this != &other)
+        {
+            reset();
+            ops = other.ops;
+            if (ops)
+                ops->move(storage, other.storage);
+            other.ops = nullptr;
+        }
+        return *this;
+    }
+
+    Task(const Task &) = delete;
+    Task &operator=(const Task &) = delete;
+
+    ~Task() { reset(); }
+
+    explicit operator bool() const { return ops != nullptr; }
+
+    void operator()() { ops->invoke(storage); }
+
+private:
+    struct Ops
+    {
+        void (*invoke)(void *);
+        void (*move)(void *dst, void *src);  // Leaves src destroyed
+        void (*destroy)(void *);
+    };
+
+    template <class Fn>
+    static constexpr Ops inlineOps = {
+        [](void *p) { (*static_cast<Fn *>(p))(); },
+        [](void *dst, void *src)
+        {
+            ::new (dst) Fn(std::move(*static_cast<Fn *>(src)));
+            static_cast<Fn *>(src)->~Fn();
+        },
+        [](void *p) { static_cast<Fn *>(p)->~Fn(); },
+    };
+
+    template <class Fn>
+    static constexpr Ops heapOps = {
+        [](void *p) { (**static_cast<Fn **>(p))(); },
+        [](void *dst, void *src) { ::new (dst) Fn *(*static_cast<Fn **>(src)); },
+        [](void *p) { delete *static_cast<Fn **>(p); },
+    };
+
+    void reset()
+    {
+        if (ops)
+            ops->destroy(storage);
+        ops = nullptr;
+    }
+
+    alignas(std::max_align_t) unsigned char storage[InlineSize];
+    const Ops *ops = nullptr;
+};
+
+// Work-stealing pool. Each worker owns a deque: it pushes and pops at the
+// back, idle workers steal from the front of the others. Tasks submitted
+// from a worker stay on that worker's deque; tasks submitted from outside
+// are spread round-robin. Idle workers spin briefly before parking on a
+// futex, and wait() puts the calling thread to work instead of blocking.
 class ThreadPool
 {
 public:
     explicit ThreadPool(size_t threadCount)
-        : stop(false), activeTasks(0)
+        : queues(std::max<size_t>(1, threadCount))
+    {
+        workers.reserve(queues.size());
+        for (size_t i = 0; i < queues.size(); ++i)
+            workers.emplace_back([this, i]
+                                 { workerLoop(i); });
+    }
+
+    ~ThreadPool()
+    {
+        stop.store(true, std::memory_order_release);
+        epoch.fetch_add(1, std::memory_order_seq_cst);
+        epoch.notify_all();
+        for (auto &t : workers)
+            t.join();
+    }
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    size_t size() const { return workers.size(); }
+
+    template <class F>
+    void enqueue(F &&task)
     {
-        threadCount = std::max<size_t>(1, threadCount);
+        size_t index = (current.pool == this)
+                           ? current.index
+                           : next.fetch_add(1, std::memory_order_relaxed) % queues.size();
 
-        for (size_t i = 0; i < threadCount; ++i)
+        // Count the task before it becomes visible so wait() cannot see zero early
+        pending.fetch_add(1, std::memory_order_relaxed);
+        queues[index].push(Task(std::forward<F>(task)));
+
+        epoch.fetch_add(1, std::memory_order_seq_cst);
+        if (sleepers.load(std::memory_order_seq_cst) > 0)
+            epoch.notify_one();
+    }
+
+    // Runs the first task on the calling thread, skipping the handoff to a
+    // worker, then helps until the pool is idle: like wait(), that includes
+    // tasks other callers put on the pool meanwhile, not only its own.
+    template <class F>
+    void runAndWait(F &&first)
+    {
+        std::forward<F>(first)();
+        wait();
+    }
+
+    // Helps drain the queues, then blocks until every queued task has
+    // finished, whoever enqueued it
+    void wait()
+    {
+        unsigned idle = 0;
+        while (true)
         {
-            workers.emplace_back([this]
-                                 {
-                while (true) {
-                    std::function<void()> task;
-
-                    {
-                        std::unique_lock<std::mutex> lock(mutex);
-                        cv.wait(lock, [this] {
-                            return stop || !tasks.empty();
-                        });
-
-                        if (stop && tasks.empty())
-                            return;
-
-                        task = std::move(tasks.front());
-                        tasks.pop();
-                        activeTasks++;
-                    }
-
-                    task();
-
-                    {
-                        std::lock_guard<std::mutex> lock(mutex);
-                        activeTasks--;
-                    }
-                    done.notify_one();
-                } });
+            uint32_t left = pending.load(std::memory_order_acquire);
+            if (left == 0)
+                return;
+
+            Task task;
+            if (stealTask(0, task))
+            {
+                execute(task);
+                idle = 0;
+            }
+            else if (++idle < SpinLimit)
+            {
+                cpuRelax();
+            }
+            else
+            {
+                pending.wait(left, std::memory_order_acquire);
+                idle = 0;
+            }
         }
     }
 
-    ~ThreadPool()
+private:
+    static constexpr unsigned SpinLimit = 256;
+
+    class alignas(64) WorkQueue
     {
+    public:
+        void push(Task &&task)
         {
-            std::lock_guard<std::mutex> lock(mutex);
-            stop = true;
+            lock();
+            tasks.push_back(std::move(task));
+            unlock();
         }
-        cv.notify_all();
-        for (auto &t : workers)
-            t.join();
+
+        // Owner end: newest first, while its data is still hot in cache
+        bool pop(Task &out)
+        {
+            lock();
+            bool found = !tasks.empty();
+            if (found)
+            {
+                out = std::move(tasks.back());
+                tasks.pop_back();
+            }
+            unlock();
+            return found;
+        }
+
+        // Thief end: oldest first
+        bool steal(Task &out)
+        {
+            lock();
+            bool found = !tasks.empty();
+            if (found)
+            {
+                out = std::move(tasks.front());
+                tasks.pop_front();
+            }
+            unlock();
+            return found;
+        }
+
+    private:
+        void lock()
+        {
+            while (flag.test_and_set(std::memory_order_acquire))
+            {
+                while (flag.test(std::memory_order_relaxed))
+                    cpuRelax();
+            }
+        }
+
+        void unlock() { flag.clear(std::memory_order_release); }
+
+        std::atomic_flag flag;
+        std::deque<Task> tasks;
+    };
+
+    // Zero-initialised like every thread_local: no pool, queue 0
+    struct Current
+    {
+        const ThreadPool *pool;
+        size_t index;
+    };
+
+    static inline thread_local Current current;
+
+    static void cpuRelax()
+    {
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+#elif defined(__aarch64__)
+        asm volatile("yield");
+#else
+        std::this_thread::yield();
+#endif
     }
 
-    inline void enqueue(std::function<void()> task)
+    bool findTask(size_t self, Task &out)
     {
+        return queues[self].pop(out) || stealTask(self + 1, out);
+    }
+
+    bool stealTask(size_t start, Task &out)
+    {
+        for (size_t n = 0; n < queues.size(); ++n)
         {
-            std::lock_guard<std::mutex> lock(mutex);
-            tasks.push(std::move(task));
+            if (queues[(start + n) % queues.size()].steal(out))
+                return true;
         }
-        cv.notify_one();
+        return false;
     }
 
-    inline void wait()
+    void execute(Task &task)
     {
-        std::unique_lock<std::mutex> lock(mutex);
-        done.wait(lock, [this]
-                  { return tasks.empty() && activeTasks == 0; });
+        task();
+        task = Task();
+        if (pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            pending.notify_all();
     }
 
-private:
-    std::vector<std::thread> workers;
-    std::queue<std::function<void()>> tasks;
+    void workerLoop(size_t index)
+    {
+        current = {this, index};
+
+        unsigned idle = 0;
+        while (true)
+        {
+            Task task;
+            if (findTask(index, task))
+            {
+                execute(task);
+                idle = 0;
+                continue;
+            }
+
+            if (stop.load(std::memory_order_acquire))
+                return;
+
+            if (++idle < SpinLimit)
+            {
+                cpuRelax();
+                continue;
+            }
 
-    std::mutex mutex;
-    std::condition_variable cv;
-    std::condition_variable done;
+            // Announce the sleep before the final look at the queues: a
+            // producer either sees us in sleepers or we see its task.
+            sleepers.fetch_add(1, std::memory_order_seq_cst);
+            uint32_t seen = epoch.load(std::memory_order_seq_cst);
+            if (!findTask(index, task))
+            {
+                if (!stop.load(std::memory_order_acquire))
+                    epoch.wait(seen, std::memory_order_seq_cst);
+            }
+            sleepers.fetch_sub(1, std::memory_order_relaxed);
+
+            if (task)
+                execute(task);
+            idle = 0;
+        }
+    }
+
+    std::vector<WorkQueue> queues;
+    std::vector<std::thread> workers;
 
-    std::atomic<bool> stop;
-    std::atomic<size_t> activeTasks;
+    std::atomic<size_t> next{0};
+    std::atomic<uint32_t> pending{0};
+    std::atomic<uint32_t> epoch{0};
+    std::atomic<uint32_t> sleepers{0};
+    std::atomic<bool> stop{false};
 };
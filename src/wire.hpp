@@ -0,0 +1,205 @@
+#pragma once
+#include "sysinfo.hpp"
+#include <cstring>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+// Field-by-field binary encoding shared by the daemon protocol and the
+// static cache: integers as 8 little-endian bytes, floating point as the
+// bit pattern of a double, bools as one byte, strings and vectors length-prefixed. Writer and
+// Reader walk the same visit() functions, so layouts cannot drift apart.
+
+namespace SystemInfo::wire {
+
+// std::string, or the std::pmr::string of an ArenaInfo
+template <class T>
+inline constexpr bool isString = false;
+template <class A>
+inline constexpr bool isString<std::basic_string<char, std::char_traits<char>, A>> = true;
+
+class Writer {
+public:
+    template <class T>
+    void operator()(const T& v) {
+        if constexpr (isString<T> || std::is_same_v<T, Atom>) {
+            put(v.size());
+            out.append(std::string_view(v));
+        } else if constexpr (std::is_same_v<T, bool>) {
+            out.push_back(v ? 1 : 0);
+        } else if constexpr (std::is_floating_point_v<T>) {
+            double d = v;
+            uint64_t bits;
+            std::memcpy(&bits, &d, sizeof(bits));
+            put(bits);
+        } else {
+            put(static_cast<uint64_t>(v));
+        }
+    }
+
+    template <class T, class A, class F>
+    void list(const std::vector<T, A>& v, F&& each) {
+        put(v.size());
+        for (const T& x : v) each(x);
+    }
+
+    std::string out;
+
+private:
+    void put(uint64_t v) {
+        char bytes[8];
+        for (int i = 0; i < 8; ++i) bytes[i] = static_cast<char>(v >> (8 * i));
+        out.append(bytes, sizeof(bytes));
+    }
+};
+
+class Reader {
+public:
+    explicit Reader(std::string_view in) : in_(in) {}
+
+    template <class T>
+    void operator()(T& v) {
+        if constexpr (isString<T> || std::is_same_v<T, Atom>) {
+            uint64_t n = get();
+            if (n > in_.size()) { ok_ = false; return; }
+            v = in_.substr(0, n);
+            in_.remove_prefix(n);
+        } else if constexpr (std::is_same_v<T, bool>) {
+            if (in_.empty()) { ok_ = false; return; }
+            v = in_.front() != 0;
+            in_.remove_prefix(1);
+        } else if constexpr (std::is_floating_point_v<T>) {
+            uint64_t bits = get();
+            double d;
+            std::memcpy(&d, &bits, sizeof(d));
+            v = static_cast<T>(d);
+        } else {
+            v = static_cast<T>(get());
+        }
+    }
+
+    template <class T, class A, class F>
+    void list(std::vector<T, A>& v, F&& each) {
+        uint64_t n = get();
+        // Every element takes at least one byte, which bounds a corrupt count
+        if (n > in_.size()) { ok_ = false; return; }
+        v.resize(n);
+        for (T& x : v) each(x);
+    }
+
+    uint64_t get() {
+        if (in_.size() < 8) { ok_ = false; return 0; }
+        uint64_t v = 0;
+        for (int i = 0; i < 8; ++i)
+            v |= static_cast<uint64_t>(static_cast<unsigned char>(in_[i])) << (8 * i);
+        in_.remove_prefix(8);
+        return v;
+    }
+
+    bool ok() const { return ok_; }
+
+private:
+    std::string_view in_;
+    bool ok_ = true;
+};
+
+// T is U, or the same part of an Info with another allocator
+template <class T, class U>
+struct SamePart : std::is_same<T, U> {};
+template <template <class> class Part, class A, class B>
+struct SamePart<Part<A>, Part<B>> : std::true_type {};
+
+template <class T, class U>
+concept Of = SamePart<std::remove_const_t<T>, U>::value;
+
+template <class IO, class T> requires Of<T, Display>
+void visit(IO& io, T& d) {
+    io(d.name); io(d.width); io(d.height); io(d.refresh_rate);
+    io(d.size_inches); io(d.is_builtin); io(d.output_name); io(d.current_mode);
+}
+
+template <class IO, class T> requires Of<T, Disk>
+void visit(IO& io, T& d) {
+    io(d.mount_point); io(d.filesystem); io(d.total_bytes); io(d.used_bytes);
+    io(d.available_bytes); io(d.free_bytes); io(d.usage_percent);
+}
+
+template <class IO, class T> requires Of<T, NetworkInterface>
+void visit(IO& io, T& n) {
+    io(n.name); io(n.ipv4); io(n.ipv6); io(n.mac); io(n.subnet_mask);
+    io(n.is_up); io(n.is_wireless); io(n.operstate);
+    io.list(n.ipv4_addresses, [&](auto& ip) { io(ip); });
+    io(n.ifindex); io(n.mtu);
+    io(n.rx_bytes); io(n.tx_bytes); io(n.rx_packets); io(n.tx_packets);
+    io(n.rx_errors); io(n.tx_errors); io(n.rx_dropped); io(n.tx_dropped);
+}
+
+template <class IO, class T> requires Of<T, Battery>
+void visit(IO& io, T& b) {
+    io(b.name); io(b.percentage); io(b.status); io(b.is_charging);
+    io(b.ac_connected); io(b.time_remaining_mins); io(b.voltage); io(b.capacity_mah);
+}
+
+template <class IO, class T> requires Of<T, GPU>
+void visit(IO& io, T& g) {
+    io(g.model); io(g.vendor); io(g.driver); io(g.freq_ghz);
+    io(g.memory_mb); io(g.is_integrated); io(g.temperature);
+}
+
+template <class IO, class T> requires Of<T, CPUMetrics>
+void visit(IO& io, T& m) {
+    auto each = [&](auto& x) { io(x); };
+    io.list(m.freq_ghz, each); io.list(m.temp_c, each); io.list(m.utilization, each);
+    io.list(m.online, each);
+    io.list(m.package, each); io.list(m.core, each); io.list(m.node, each);
+    // A corrupt blob could leave the arrays different lengths
+    if constexpr (!std::is_const_v<T>) m.resize(m.size());
+}
+
+template <class IO, class T> requires Of<T, Info>
+void visit(IO& io, T& info) {
+    io(info.username); io(info.hostname); io(info.os_name); io(info.os_version);
+    io(info.os_codename); io(info.os_id); io(info.kernel); io(info.kernel_version);
+    io(info.architecture);
+
+    io(info.model); io(info.manufacturer); io(info.bios_version);
+    io(info.board_name); io(info.chassis_type);
+
+    io(info.shell); io(info.shell_version); io(info.terminal); io(info.terminal_version);
+
+    io(info.uptime_seconds); io(info.boot_time); io(info.current_time);
+    io(info.locale); io(info.timezone);
+
+    auto& cpu = info.cpu;
+    io(cpu.model); io(cpu.vendor); io(cpu.core_count); io(cpu.thread_count);
+    io(cpu.max_freq_ghz); io(cpu.current_freq_ghz); io(cpu.architecture);
+    visit(io, cpu.per_cpu);
+
+    io.list(info.gpus, [&](auto& g) { visit(io, g); });
+
+    auto& mem = info.memory;
+    io(mem.total_bytes); io(mem.used_bytes); io(mem.available_bytes); io(mem.free_bytes);
+    io(mem.cached_bytes); io(mem.buffers_bytes); io(mem.usage_percent);
+
+    auto& swap = info.swap;
+    io(swap.total_bytes); io(swap.used_bytes); io(swap.free_bytes); io(swap.usage_percent);
+
+    io.list(info.displays, [&](auto& d) { visit(io, d); });
+    io.list(info.disks, [&](auto& d) { visit(io, d); });
+    io.list(info.network_interfaces, [&](auto& n) { visit(io, n); });
+    io.list(info.batteries, [&](auto& b) { visit(io, b); });
+
+    auto& de = info.de;
+    io(de.name); io(de.version); io(de.wm_name); io(de.wm_protocol); io(de.theme);
+    io(de.wm_theme); io(de.icon_theme); io(de.cursor_theme); io(de.cursor_size);
+    io(de.font_name); io(de.font_size);
+
+    io.list(info.packages, [&](auto& p) { io(p.manager_name); io(p.count); });
+    io(info.total_packages); io(info.package_managers);
+    io.list(info.unavailable, [&](auto& name) { io(name); });
+    io.list(info.parse_errors, [&](auto& e) { io(e); });
+}
+
+} // namespace SystemInfo::wire